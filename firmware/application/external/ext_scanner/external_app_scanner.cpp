@@ -1,4 +1,5 @@
 #include "ui_external_app_scanner.hpp"
+#include "scanner_recording.hpp"
 #include "portapack.hpp"
 #include "baseband_api.hpp"
 #include "radio.hpp"
@@ -8,6 +9,8 @@
 #include "ui_textentry.hpp"
 #include "spi_image.hpp"
 #include "external_app.hpp"
+#include "spectrum_color_lut.hpp"
+#include "hal.h"
 #include <cmath>
 #include <algorithm>
 
@@ -171,10 +174,126 @@ void RangeManagerView::edit_range(size_t index) {
     }
 }
 
+// ==========================================
+// ScannerStatsView Implementation
+// ==========================================
+
+ScannerStatsView::ScannerStatsView(NavigationView& nav, const SweepStats& stats, const SweepPipeline& pipeline)
+    : nav_(nav), stats_(stats), pipeline_(pipeline)
+{
+    add_children({
+        &console,
+        &text_saved,
+        &button_refresh,
+        &button_save,
+        &button_back
+    });
+    
+    button_refresh.on_select = [this](Button&) {
+        refresh();
+    };
+    
+    button_save.on_select = [this](Button&) {
+        save();
+    };
+    
+    button_back.on_select = [this](Button&) {
+        nav_.pop();
+    };
+}
+
+void ScannerStatsView::focus() {
+    button_refresh.focus();
+}
+
+void ScannerStatsView::on_show() {
+    refresh();
+}
+
+void ScannerStatsView::refresh() {
+    console.clear(true);
+    
+    TextLine line;
+    for (size_t i = 0; i < SweepStats::LINE_COUNT; i++) {
+        stats_.format_line(i, pipeline_, line);
+        console.writeln(line.c_str());
+    }
+}
+
+void ScannerStatsView::save() {
+    // Same lines as on screen: /SCANNER/STATS_nnnn.TXT
+    const std::filesystem::path stats_dir = u"/SCANNER";
+    ensure_directory(stats_dir);
+    
+    const auto path = next_filename_matching_pattern(stats_dir / u"STATS_????.TXT");
+    File file;
+    bool ok = !file.create(path);
+    
+    TextLine line;
+    for (size_t i = 0; ok && i < SweepStats::LINE_COUNT; i++) {
+        stats_.format_line(i, pipeline_, line);
+        ok = !file.write(line.c_str(), line.size()).is_error() &&
+             !file.write("\r\n", 2).is_error();
+    }
+    
+    text_saved.set(ok ? "Saved " + path.filename().string() : "ERROR: SD card");
+}
+
+// ==========================================
+// OverviewStrip Implementation
+// ==========================================
+
+void OverviewStrip::paint(Painter& painter) {
+    const auto r = screen_rect();
+    painter.fill_rectangle(r, Color::black());
+    
+    const size_t range_count = overview_.range_count();
+    if (range_count == 0 || r.width() > 240) return;
+    
+    // Each range gets an equal share of the width, whatever its span
+    const size_t slot_width = r.width() / range_count;
+    std::array<Color, 240> pixels;
+    
+    for (size_t age = 0; (int)(age + 1) * ROW_HEIGHT <= r.height(); age++) {
+        if (!overview_.row(0, age)) break;
+        
+        pixels.fill(Color::black());
+        for (size_t slot = 0; slot < range_count; slot++) {
+            const uint8_t* row = overview_.row(slot, age);
+            for (size_t x = 0; x < slot_width; x++) {
+                pixels[slot * slot_width + x] = spectrum_rgb3_lut[row[x * overview_.columns() / slot_width]];
+            }
+        }
+        
+        for (int y = 0; y < ROW_HEIGHT; y++) {
+            portapack::display.draw_pixels({r.left(), r.top() + (int)age * ROW_HEIGHT + y, 240, 1}, pixels);
+        }
+    }
+}
+
 // ==========================================
 // ScannerAppView Implementation
 // ==========================================
 
+namespace {
+
+// Microseconds, wrapping every ~71 minutes; differences are valid across the wrap.
+// The application core has neither SysTick nor DWT: ChibiOS runs its tick from the RI
+// timer, which counts up to COMPVAL and restarts, so its counter is the sub-tick part.
+uint32_t timestamp_us() {
+    constexpr uint32_t US_PER_TICK = 1000000 / CH_FREQUENCY;
+    systime_t ticks;
+    uint32_t counter;
+    do {
+        ticks = chTimeNow();
+        counter = LPC_RITIMER->COUNTER;
+    } while (ticks != chTimeNow());  // Tick interrupt in between, counter restarted
+    
+    return ticks * US_PER_TICK + counter * US_PER_TICK / (LPC_RITIMER->COMPVAL + 1);
+}
+
+}  // namespace
+
 ScannerAppView::ScannerAppView(NavigationView& nav)
     : nav_(nav),
       scan_ranges{}
@@ -186,13 +305,21 @@ ScannerAppView::ScannerAppView(NavigationView& nav)
         &labels,
         &text_range_count,
         &button_manage_ranges,
+        &button_stats,
         &field_threshold,
         &text_threshold_unit,
+        &field_settle,
+        &field_floor_margin,
+        &text_floor_unit,
         &field_bw_min,
         &text_bw_min_unit,
         &field_bw_max,
         &text_bw_max_unit,
-        &text_mode,
+        &field_overlap,
+        &checkbox_record,
+        &field_dwell,
+        &options_dwell_mode,
+        &text_cycle_time,
         &button_scan_start,
         &button_pause_resume,
         &button_scan_stop,
@@ -201,7 +328,8 @@ ScannerAppView::ScannerAppView(NavigationView& nav)
         &text_rssi,
         &text_widest,
         &text_dome_signals,
-        &text_status
+        &text_status,
+        &overview_strip
     });
     
     // Initially hide PAUSE and STOP buttons
@@ -220,10 +348,16 @@ void ScannerAppView::on_show() {
     field_threshold.set_value(squelch_threshold);
     field_bw_min.set_value(min_signal_width_mhz);
     field_bw_max.set_value(max_signal_width_mhz);
+    field_settle.set_value(settle_frames);
+    field_overlap.set_value(overlap_bins);
+    field_dwell.set_value(dwell_frames);
+    options_dwell_mode.set_by_value((int32_t)dwell_mode);
+    field_floor_margin.set_value(floor_margin_db);
     
     // Set up callbacks
     field_threshold.on_change = [this](int32_t v) {
         squelch_threshold = v;
+        update_detector_config();
     };
     
     field_bw_min.on_change = [this](int32_t v) {
@@ -232,6 +366,7 @@ void ScannerAppView::on_show() {
             max_signal_width_mhz = min_signal_width_mhz;
             field_bw_max.set_value(max_signal_width_mhz);
         }
+        update_detector_config();
     };
     
     field_bw_max.on_change = [this](int32_t v) {
@@ -240,12 +375,43 @@ void ScannerAppView::on_show() {
             min_signal_width_mhz = max_signal_width_mhz;
             field_bw_min.set_value(min_signal_width_mhz);
         }
+        update_detector_config();
+    };
+    
+    field_floor_margin.on_change = [this](int32_t v) {
+        floor_margin_db = v;
+        update_detector_config();
+    };
+    
+    field_settle.on_change = [this](int32_t v) {
+        settle_frames = v;
+        pipeline.set_settle_frames(settle_frames);
+    };
+    
+    field_overlap.on_change = [this](int32_t v) {
+        overlap_bins = v;  // Used from the next START
+    };
+    
+    field_dwell.on_change = [this](int32_t v) {
+        dwell_frames = v;
+        dwell.configure(dwell_frames, dwell_mode);
+    };
+    
+    options_dwell_mode.on_change = [this](size_t, int32_t v) {
+        dwell_mode = (DwellMode)v;
+        dwell.configure(dwell_frames, dwell_mode);
     };
     
     button_manage_ranges.on_select = [this](Button&) {
+        // Chunk ids change with the ranges
+        noise_floor.clear();
         nav_.push<RangeManagerView>(scan_ranges);
     };
     
+    button_stats.on_select = [this](Button&) {
+        nav_.push<ScannerStatsView>(stats, pipeline);
+    };
+    
     button_scan_start.on_select = [this](Button&) {
         start_scanning();
     };
@@ -290,22 +456,11 @@ void ScannerAppView::update_range_count() {
     text_range_count.set(to_string_dec_uint(scan_ranges.size()) + " ranges");
 }
 
-void ScannerAppView::calculate_chunk_count() {
-    if (current_range_index >= scan_ranges.size()) {
-        total_chunks_in_range = 0;
-        return;
-    }
-    
-    auto& range = scan_ranges[current_range_index];
-    rf::Frequency range_width = range.end - range.start;
-    total_chunks_in_range = (range_width + SPECTRUM_SLICE_WIDTH - 1) / SPECTRUM_SLICE_WIDTH;
-}
-
 void ScannerAppView::start_scanning() {
     if (is_scanning) return;
     
     if (scan_ranges.empty()) {
-        text_status.set("ERROR: No ranges");
+        set_status("ERROR: No ranges");
         return;
     }
     
@@ -319,20 +474,16 @@ void ScannerAppView::start_scanning() {
     }
     
     if (!has_enabled) {
-        text_status.set("ERROR: No enabled");
+        set_status("ERROR: No enabled");
         return;
     }
     
     is_scanning = true;
     
-    // Find first enabled range
-    current_range_index = 0;
-    while (current_range_index < scan_ranges.size() && !scan_ranges[current_range_index].enabled) {
-        current_range_index++;
-    }
-    
-    if (current_range_index >= scan_ranges.size()) {
-        text_status.set("ERROR: No enabled");
+    // Position on the first chunk of the first enabled range
+    scheduler.set_overlap_bins(overlap_bins);
+    if (!scheduler.start()) {
+        set_status("ERROR: No enabled");
         is_scanning = false;
         return;
     }
@@ -341,7 +492,7 @@ void ScannerAppView::start_scanning() {
     in_scan_cycle = false;  // Disable cycle locking behavior
     best_freq_in_cycle = 0;
     best_rssi_in_cycle = -999;
-    start_range_index = current_range_index;
+    start_range_index = scheduler.current().range_index;
     
     // Initialize signal tracking
     widest_signal_width = 0;
@@ -349,17 +500,18 @@ void ScannerAppView::start_scanning() {
     widest_signal_rssi = -999;
     dome_signals_count = 0;
     threat_detected = false;
-    signal_at_chunk_end = false;
-    text_widest.set("Widest: ---");
-    text_dome_signals.set("FPV Threats: 0");
-    
-    // Calculate chunk info for current range
-    calculate_chunk_count();
-    current_chunk_in_range = 0;
-    
-    // Calculate first chunk center
-    auto& first_range = scan_ranges[current_range_index];
-    current_chunk_center = first_range.start + (SPECTRUM_SLICE_WIDTH / 2);
+    emitters.clear();
+    update_detector_config();
+    detector.reset();
+    noise_floor.clear();
+    overview.configure(scan_ranges, scheduler.overlap_bins(), OVERVIEW_COLUMNS, OVERVIEW_ROWS);
+    overview_strip.set_dirty();
+    
+    pipeline.set_settle_frames(settle_frames);
+    pipeline.reset_counters();
+    stats.clear();
+    dwell.configure(dwell_frames, dwell_mode);
+    cycle_frames_per_chunk = settle_frames + dwell_frames;
     
     // Update button visibility
     button_scan_start.hidden(true);
@@ -373,7 +525,16 @@ void ScannerAppView::start_scanning() {
     button_scan_stop.set_focusable(true);
     
     set_dirty();
-    text_status.set("Status: Scanning");
+    
+    // Chunks past the floor table fall back to Threshold, don't let that go unnoticed
+    const size_t chunk_count = sweep_chunk_count(scan_ranges, scheduler.overlap_bins());
+    if (floor_margin_db > 0 && chunk_count > NoiseFloorModel::MAX_CHUNKS) {
+        TextLine status{"Floor+ on "};
+        status.append_uint(NoiseFloorModel::MAX_CHUNKS).append('/').append_uint(chunk_count);
+        set_status(status.append(" chunks"));
+    } else {
+        set_status("Status: Scanning");
+    }
     
     // Configure receiver and spectrum capture
     receiver_model.set_sampling_rate(SPECTRUM_SLICE_WIDTH);
@@ -388,12 +549,15 @@ void ScannerAppView::start_scanning() {
     baseband::set_spectrum(SPECTRUM_SLICE_WIDTH, 0);
     
     // Tune to first chunk (use direct radio API for speed)
-    tune_to_chunk_center(current_chunk_center);
+    tune_to_chunk_center(scheduler.current().center);
+    cycle_start_us = timestamp_us();
+    
+    if (checkbox_record.value()) {
+        start_recording();
+    }
     
     // Start spectrum streaming
     baseband::spectrum_streaming_start();
-    
-    update_display();
 }
 
 void ScannerAppView::pause_scanning() {
@@ -412,7 +576,7 @@ void ScannerAppView::pause_scanning() {
     button_scan_stop.set_focusable(true);
     
     set_dirty();
-    text_status.set("Status: Paused");
+    set_status("Status: Paused");
 }
 
 void ScannerAppView::resume_scanning() {
@@ -431,7 +595,7 @@ void ScannerAppView::resume_scanning() {
     button_scan_stop.set_focusable(true);
     
     set_dirty();
-    text_status.set("Status: Scanning");
+    set_status("Status: Scanning");
 }
 
 void ScannerAppView::stop_scanning() {
@@ -443,6 +607,7 @@ void ScannerAppView::stop_scanning() {
     // Stop streaming and disable receiver
     baseband::spectrum_streaming_stop();
     receiver_model.disable();
+    stop_recording();
     // Note: Keep audio running for alert beeps!
     // Audio will be stopped in destructor
     
@@ -456,334 +621,340 @@ void ScannerAppView::stop_scanning() {
     button_scan_stop.set_focusable(false);
     
     set_dirty();
-    text_status.set("Status: Stopped");
+    set_status("Status: Stopped");
+}
+
+bool ScannerAppView::scan_next_chunk() {
+    bool cycle_complete = scheduler.advance();
+    tune_to_chunk_center(scheduler.current().center);
+    return cycle_complete;
 }
 
-void ScannerAppView::scan_next_chunk() {
-    if (current_range_index >= scan_ranges.size()) return;
+void ScannerAppView::on_threat_confirmed() {
+    // FPV DRONE DETECTED - STOP AND ALERT!
+    // Play long alert beep BEFORE stopping (so audio is still active)
+    baseband::request_audio_beep(1000, 24000, 500);
     
-    current_chunk_in_range++;
+    // Now stop scanning
+    stop_scanning();  // User must manually restart
     
-    auto& current_range = scan_ranges[current_range_index];
+    // After the stop, so "Stopped" doesn't replace the alert. The threats line shows
+    // the strongest of them, the one to look for.
+    TextLine status{"*** FPV DRONE "};
+    set_status(status.append_uint(dome_signals_count).append(" ***"));
+}
+
+void ScannerAppView::on_cycle_complete() {
+    overview.next_row();
+    overview_strip.set_dirty();
     
-    if (current_chunk_in_range >= total_chunks_in_range) {
-        // Finished current range, move to next
-        move_to_next_range();
+    const auto report = emitters.end_cycle();
+    best_freq_in_cycle = report.strongest ? report.strongest->peak_freq : 0;
+    best_rssi_in_cycle = report.strongest ? report.strongest->peak_rssi : -999;
+    
+    if (threat_detected) {
+        on_threat_confirmed();
         return;
     }
     
-    // Calculate next chunk center
-    current_chunk_center = current_range.start + 
-        (SPECTRUM_SLICE_WIDTH / 2) + 
-        (current_chunk_in_range * SPECTRUM_SLICE_WIDTH);
-    
-    // Ensure we don't exceed range end
-    if (current_chunk_center - (SPECTRUM_SLICE_WIDTH / 2) > current_range.end) {
-        move_to_next_range();
-        return;
+    // No threats - continue scanning
+    const uint32_t now_us = timestamp_us();
+    stats.add_cycle(now_us - cycle_start_us);
+    last_cycle_ms = (now_us - cycle_start_us) / 1000;
+    last_cycle_frames_per_chunk = cycle_frames_per_chunk;
+    cycle_start_us = now_us;
+    cycle_frames_per_chunk = settle_frames + dwell_frames;
+    
+    // Newly appeared emitters matter most, otherwise the strongest one
+    TextLine status{"Cycle "};
+    status.append_uint(last_cycle_ms).append("ms");
+    if (report.new_count > 0) {
+        status.append(" new ").append_mhz(report.newest->peak_freq);
+    } else if (report.strongest) {
+        status.append(" top ").append_mhz(best_freq_in_cycle);
+    } else {
+        status.append(" (clear)");
     }
+    set_status(status);
+}
+
+void ScannerAppView::tune_to_chunk_center(rf::Frequency center_freq) {
+    const uint32_t start_us = timestamp_us();
+    
+    // Use direct radio tuning like Looking Glass (faster, doesn't save to persistent memory)
+    radio::set_tuning_frequency(center_freq);
+    pipeline.retuned();
+    dwell.reset();
+    flush_stale_frames();
     
-    tune_to_chunk_center(current_chunk_center);
-    baseband::spectrum_streaming_start();  // Restart streaming after retune
-    update_display();
+    // Settle time counts from here to the first accepted frame
+    tune_end_us = timestamp_us();
+    chunk_has_frame = false;
+    stats.add(SweepStage::Tune, tune_end_us - start_us);
 }
 
-void ScannerAppView::move_to_next_range() {
-    current_range_index++;
+void ScannerAppView::flush_stale_frames() {
+    // Frames still queued were computed before the retune
+    if (!fifo) return;
     
-    // Skip disabled ranges
-    while (current_range_index < scan_ranges.size() && !scan_ranges[current_range_index].enabled) {
-        current_range_index++;
+    ChannelSpectrum stale_spectrum;
+    while (fifo->out(stale_spectrum)) {
+        pipeline.stale_frame();
     }
-    
-    if (current_range_index >= scan_ranges.size()) {
-        // Completed one full scan cycle
-        
-        if (threat_detected) {
-            // FPV DRONE DETECTED - STOP AND ALERT!
-            text_status.set("*** FPV DRONE " + to_string_dec_uint(dome_signals_count) + " ***");
-            
-            // Play long alert beep BEFORE stopping (so audio is still active)
-            baseband::request_audio_beep(1000, 24000, 500);
-            
-            // Now stop scanning
-            stop_scanning();
-            return;  // Stop here - user must manually restart
+}
+
+void ScannerAppView::on_frame_sync() {
+    if (fifo) {
+        ChannelSpectrum channel_spectrum;
+        uint32_t frames = 0;
+        while (fifo->out(channel_spectrum)) {
+            on_channel_spectrum(channel_spectrum);
+            frames++;
         }
-        
-        // No threats - continue scanning
-        current_range_index = 0;
-        while (current_range_index < scan_ranges.size() && !scan_ranges[current_range_index].enabled) {
-            current_range_index++;
+        if (is_scanning && frames > 1) {
+            stats.add_backlog(frames - 1);
         }
-        
-        text_status.set("Status: Cycle " + to_string_dec_uint(dome_signals_count) + " (clear)");
     }
     
-    // Start scanning new range
-    if (current_range_index < scan_ranges.size()) {
-        calculate_chunk_count();
-        current_chunk_in_range = 0;
-        
-        auto& new_range = scan_ranges[current_range_index];
-        current_chunk_center = new_range.start + (SPECTRUM_SLICE_WIDTH / 2);
-        
-        tune_to_chunk_center(current_chunk_center);
-        baseband::spectrum_streaming_start();  // Restart streaming after retune
-        update_display();
+    // However many frames were analyzed, widgets are redrawn at most once per display frame
+    const uint32_t start_us = timestamp_us();
+    refresh_display();
+    if (is_scanning) {
+        stats.add(SweepStage::Format, timestamp_us() - start_us);
     }
 }
 
-void ScannerAppView::tune_to_chunk_center(rf::Frequency center_freq) {
-    // Use direct radio tuning like Looking Glass (faster, doesn't save to persistent memory)
-    radio::set_tuning_frequency(center_freq);
-}
-
 void ScannerAppView::on_channel_spectrum(const ChannelSpectrum& spectrum) {
     if (!is_scanning || is_paused) return;
     
-    // Stop streaming while processing
-    baseband::spectrum_streaming_stop();
+    // Streaming keeps running across retunes; skip frames captured while the radio settles
+    if (!pipeline.accept_frame()) return;
+    
+    const uint32_t arrival_us = timestamp_us();
+    if (!chunk_has_frame) {
+        chunk_has_frame = true;
+        chunk_first_frame_us = arrival_us;
+        stats.add(SweepStage::Settle, arrival_us - tune_end_us);
+    }
+    
+    const ChunkSlot slot = scheduler.current();
+    record_frame(spectrum, slot);
+    
+    // Stay on the chunk until all dwell frames are integrated
+    if (!dwell.add(spectrum.db.data())) return;
+    stats.add(SweepStage::Frames, arrival_us - chunk_first_frame_us);
+    
+    // Retune to the next chunk first, so the PLL settles while this frame is analyzed
+    bool cycle_complete = scan_next_chunk();
     
     // Process the spectrum data
-    process_spectrum_bins(spectrum);
-    
-    // Move to next chunk (which will restart streaming)
-    scan_next_chunk();
-}
-
-void ScannerAppView::process_spectrum_bins(const ChannelSpectrum& spectrum) {
-    // FFT spectrum parameters
-    constexpr rf::Frequency bin_width = SPECTRUM_SLICE_WIDTH / SPECTRUM_BINS;  // ~78 kHz per bin
-    constexpr int32_t NOISE_FLOOR_DBM = -120;  // Typical RF receiver noise floor
-    constexpr int32_t MAX_SIGNAL_DBM = 0;      // Maximum signal power (1 mW)
-    constexpr uint8_t RAW_MIN = 0;             // spectrum.db[] minimum value
-    constexpr uint8_t RAW_MAX = 255;           // spectrum.db[] maximum value
-    
-    // Track signal runs (consecutive bins above threshold)
-    uint8_t max_power_in_chunk = RAW_MIN;
-    
-    // Convert dBm threshold to raw FFT value (0-255)
-    // Linear mapping: NOISE_FLOOR_DBM → 0, MAX_SIGNAL_DBM → 255
-    int32_t dbm_range = MAX_SIGNAL_DBM - NOISE_FLOOR_DBM;  // 120 dB
-    int32_t threshold_raw = ((squelch_threshold - NOISE_FLOOR_DBM) * RAW_MAX) / dbm_range;
-    if (threshold_raw < RAW_MIN) threshold_raw = RAW_MIN;
-    if (threshold_raw > RAW_MAX) threshold_raw = RAW_MAX;
-    
-    // Check if previous chunk had signal at its end (cross-chunk signal)
-    size_t signal_start_bin = 0;
-    size_t signal_end_bin = 0;
-    bool in_signal = false;
-    uint8_t signal_peak_power = 0;
-    size_t signal_peak_bin = 0;
-    
-    // If previous chunk ended with a signal, check if it continues here
-    if (signal_at_chunk_end) {
-        // Check first few bins to see if signal continues
-        bool continues = false;
-        for (size_t bin = 0; bin < 10 && bin < SPECTRUM_BINS; bin++) {
-            if (spectrum.db[bin] > threshold_raw) {
-                continues = true;
-                break;
-            }
-        }
-        
-        if (continues) {
-            // Signal spans chunks! Start tracking from bin 0
-            in_signal = true;
-            signal_start_bin = 0;
-            signal_peak_power = chunk_end_peak_power;  // Carry over peak from previous chunk
-            signal_peak_bin = 0;
-        }
-        signal_at_chunk_end = false;  // Reset flag
+    const uint32_t analysis_start_us = timestamp_us();
+    const auto& result = process_spectrum_bins(dwell.frame(), slot);
+    const bool confirmed = scheduler.report(slot, result.max_power, result.detections.data(), result.detection_count);
+    stats.add(SweepStage::Analysis, timestamp_us() - analysis_start_us);
+    
+    // A dome seen again on a revisit doesn't need to wait for the end of the cycle
+    if (confirmed) {
+        on_threat_confirmed();
+        return;
+    }
+    
+    if (cycle_complete) {
+        on_cycle_complete();
     }
+}
+
+void ScannerAppView::update_detector_config() {
+    DetectorConfig config;
+    config.squelch_threshold = squelch_threshold;
+    config.min_signal_width_mhz = min_signal_width_mhz;
+    config.max_signal_width_mhz = max_signal_width_mhz;
+    config.floor_margin_db = floor_margin_db;
+    config.overlap_bins = scheduler.overlap_bins();  // As laid out by the running scan
+    detector.set_config(config);
+}
+
+const SpectrumDetector::FrameResult& ScannerAppView::process_spectrum_bins(const uint8_t* db, const ChunkSlot& slot) {
+    FloorSegments shifted;
+    const auto& result = detector.process_frame(slot.center, db, !slot.revisit,
+                                                noise_floor.shifted_floor(slot.chunk_id, slot.shift_segments,
+                                                                          scheduler.overlap_bins(), shifted));
+    // A shifted revisit's segments don't line up with the chunk's
+    if (slot.shift_segments == 0) {
+        noise_floor.update(slot.chunk_id, result.segment_mean);
+    }
+    stats.add_detection_overflow(result.overflow_count);
+    if (!slot.revisit) {
+        overview.add(slot.range_index, slot.chunk_index, db);
+    }
+    
+    chunk_max_power = result.max_power;
+    chunk_power_valid = true;
+    
+    const Detection* best_dome = nullptr;
+    const uint32_t now_ms = (uint64_t)chTimeNow() * 1000 / CH_FREQUENCY;
     
-    for (size_t bin = 0; bin < SPECTRUM_BINS; bin++) {
-        // Get raw power value (0-255 from FFT)
-        uint8_t power_raw = spectrum.db[bin];
+    for (size_t i = 0; i < result.detection_count; i++) {
+        const auto& detection = result.detections[i];
         
-        if (power_raw > max_power_in_chunk) {
-            max_power_in_chunk = power_raw;
+        // Track widest signal for display (any signal, not just domes)
+        if (detection.width > widest_signal_width) {
+            widest_signal_width = detection.width;
+            widest_signal_freq = detection.freq;
+            widest_signal_rssi = detection.rssi;
         }
         
-        if (power_raw > threshold_raw) {
-            if (!in_signal) {
-                // Start of new signal
-                in_signal = true;
-                signal_start_bin = bin;
-                signal_peak_power = power_raw;
-                signal_peak_bin = bin;
-            } else {
-                // Continue signal
-                if (power_raw > signal_peak_power) {
-                    signal_peak_power = power_raw;
-                    signal_peak_bin = bin;
-                }
-            }
-            signal_end_bin = bin;
-        } else {
-            if (in_signal) {
-                // End of signal - analyze it
-                rf::Frequency signal_width = (signal_end_bin - signal_start_bin + 1) * bin_width;
-                
-                // If signal started at bin 0, it's a cross-chunk signal - add previous chunk portion
-                bool is_cross_chunk = (signal_start_bin == 0);
-                if (is_cross_chunk) {
-                    // Add approximate width from previous chunk
-                    // Conservative estimate: signal extended from where it started to end of chunk
-                    rf::Frequency prev_chunk_portion = (SPECTRUM_BINS - chunk_end_signal_start_bin) * bin_width;
-                    signal_width += prev_chunk_portion;
-                }
-                
-                rf::Frequency signal_freq = current_chunk_center - (SPECTRUM_SLICE_WIDTH / 2) + (signal_peak_bin * bin_width);
-                
-                // Check if signal width matches our criteria
-                rf::Frequency min_width = min_signal_width_mhz * 1000000;
-                rf::Frequency max_width = max_signal_width_mhz * 1000000;
-                
-                // Convert raw FFT value back to dBm for display
-                int32_t power_dbm = NOISE_FLOOR_DBM + 
-                    (signal_peak_power * (MAX_SIGNAL_DBM - NOISE_FLOOR_DBM) / RAW_MAX);
-                
-                if (signal_width >= min_width && signal_width <= max_width) {
-                    // Analyze FM video dome shape for FPV detection
-                    // For cross-chunk signals, we can only analyze the current chunk portion
-                    bool has_video_dome = analyze_fm_dome_shape(spectrum, signal_start_bin, signal_end_bin);
-                    
-                    // Track widest signal for display (any signal, not just domes)
-                    if (signal_width > widest_signal_width) {
-                        widest_signal_width = signal_width;
-                        widest_signal_freq = signal_freq;
-                        widest_signal_rssi = power_dbm;
-                        
-                        text_widest.set("Widest: " + to_string_dec_uint(widest_signal_width / 1000000) + 
-                                       " MHz @ " + to_string_short_freq(widest_signal_freq));
-                    }
-                    
-                    // CRITICAL: Only alert for FPV dome signals (life-saving!)
-                    if (has_video_dome) {
-                        dome_signals_count++;
-                        threat_detected = true;  // Flag to stop at cycle end
-                        text_dome_signals.set("FPV Threats: " + to_string_dec_uint(dome_signals_count));
-                        text_status.set("Status: THREAT DETECTED!");
-                        
-                        // Immediate alert beep
-                        on_signal_found(signal_freq, power_dbm, signal_width);
-                    }
-                }
-                
-                in_signal = false;
+        const auto update = emitters.update(detection, now_ms);
+        
+        // CRITICAL: Only alert for FPV dome signals (life-saving!)
+        if (detection.has_video_dome) {
+            threat_detected = true;  // Flag to stop at cycle end
+            
+            // One drone seen on many frames is one threat, only new ones count and beep.
+            // Several in one frame get one alert, for the most confident match.
+            const bool new_threat = update == EmitterTracker::Update::NewThreat ||
+                                    update == EmitterTracker::Update::BecameThreat;
+            if (new_threat && (!best_dome || detection.dome_confidence > best_dome->dome_confidence)) {
+                best_dome = &detection;
             }
         }
     }
     
-    // Handle signal that extends to end of chunk
-    if (in_signal) {
-        // Signal continues to the end - might continue in next chunk!
-        signal_at_chunk_end = true;
-        chunk_end_signal_start_bin = signal_start_bin;
-        chunk_end_peak_power = signal_peak_power;
-        pending_signal_freq = current_chunk_center - (SPECTRUM_SLICE_WIDTH / 2) + (signal_peak_bin * bin_width);
-        
-        // Calculate width seen so far (may be partial)
-        rf::Frequency partial_width = (signal_end_bin - signal_start_bin + 1) * bin_width;
+    if (best_dome) {
+        dome_signals_count = emitters.threat_count();
         
-        // If this is a continuation from previous chunk, add widths
-        if (signal_start_bin == 0) {
-            // This is a cross-chunk signal - calculate total width
-            // Estimate: signal spans from start of previous chunk continuation to end of this chunk
-            // We'll report it in the next chunk if it ends, or now if it's already > max_width
-            rf::Frequency max_width = max_signal_width_mhz * 1000000;
-            
-            if (partial_width > max_width) {
-                // Already too wide, stop tracking (likely WiFi, not FPV)
-                signal_at_chunk_end = false;  // Don't continue - too wide already
-            }
+        // Immediate alert beep
+        on_signal_found(*best_dome);
+    }
+    
+    return result;
+}
+
+void ScannerAppView::start_recording() {
+    // One file per scan session: /SCANNER/SWEEP_nnnn.SWR
+    const std::filesystem::path sweeps_dir = u"/SCANNER";
+    ensure_directory(sweeps_dir);
+    
+    record_file = std::make_unique<File>();
+    auto error = record_file->create(next_filename_matching_pattern(sweeps_dir / u"SWEEP_????.SWR"));
+    if (!error) {
+        SweepRecordingHeader header;
+        header.overlap_bins = scheduler.overlap_bins();
+        if (!record_file->write(&header, sizeof(header)).is_error()) {
+            return;
         }
-    } else {
-        // Signal ended in this chunk - reset cross-chunk tracking
-        signal_at_chunk_end = false;
     }
     
-    // Update RSSI display with max power in this chunk
-    int32_t max_dbm = NOISE_FLOOR_DBM + 
-        (max_power_in_chunk * (MAX_SIGNAL_DBM - NOISE_FLOOR_DBM) / RAW_MAX);
-    text_rssi.set("RSSI: " + to_string_dec_int(max_dbm) + " dBm (" + 
-                 to_string_dec_uint(max_power_in_chunk) + ")");
+    record_file.reset();
+    set_status("ERROR: SD card");
+}
+
+void ScannerAppView::stop_recording() {
+    record_file.reset();  // Closes the file
+}
+
+void ScannerAppView::record_frame(const ChannelSpectrum& spectrum, const ChunkSlot& slot) {
+    if (!record_file) return;
+    
+    SweepRecordingFrame frame;
+    frame.center_freq = slot.center;
+    if (slot.revisit) frame.center_freq |= SweepRecordingFrame::REVISIT_FLAG;
+    frame.db = spectrum.db;
+    
+    if (record_file->write(&frame, sizeof(frame)).is_error()) {
+        stop_recording();
+        set_status("ERROR: SD write");
+    }
 }
 
-void ScannerAppView::on_signal_found(rf::Frequency freq, int32_t rssi, rf::Frequency width) {
+void ScannerAppView::on_signal_found(const Detection& detection) {
     // Play alert tone
     play_alert_tone();
     
-    text_status.set("Signal: " + to_string_short_freq(freq) + " " +
-                   to_string_dec_uint(width / 1000000) + " MHz " +
-                   to_string_dec_int(rssi) + " dBm");
+    TextLine status{"Dome "};
+    status.append_mhz(detection.freq).append(' ');
+    status.append_uint(detection.width / 1000000).append("MHz ");
+    status.append_int(detection.rssi).append("dBm ");
+    set_status(status.append_uint(detection.dome_confidence).append('%'));
 }
 
-void ScannerAppView::update_display() {
-    if (current_range_index >= scan_ranges.size()) return;
-    
-    auto& current_range = scan_ranges[current_range_index];
-    text_current_range.set("Range: " + current_range.name);
-    
-    // Show chunk progress (e.g., "5800 MHz [3/10]")
-    rf::Frequency freq_mhz = current_chunk_center / 1000000;
-    text_current_freq.set("Chunk: " + to_string_dec_uint(freq_mhz) + " MHz [" +
-                         to_string_dec_uint(current_chunk_in_range + 1) + "/" +
-                         to_string_dec_uint(total_chunks_in_range) + "]");
+void ScannerAppView::set_status(const char* status) {
+    status_line.clear().append(status);
 }
 
-void ScannerAppView::play_alert_tone() {
-    // Play 1000 Hz beep for 200ms to alert user of FPV signal detection
-    baseband::request_audio_beep(1000, 24000, 200);
+void ScannerAppView::set_status(const TextLine& status) {
+    status_line = status;
 }
 
-void ScannerAppView::stop_alert_tone() {
-    baseband::request_beep_stop();
+namespace {
+
+// Redraw a widget only when its text changed
+void show_line(Text& text, TextLine& shown, const TextLine& line) {
+    if (line != shown) {
+        shown = line;
+        text.set(line.c_str());
+    }
 }
 
-bool ScannerAppView::analyze_fm_dome_shape(const ChannelSpectrum& spectrum, 
-                                            size_t start_bin, size_t end_bin) {
-    // Analyze spectrum shape to detect FM video "dome" characteristic of FPV drones
-    // FM video has a smooth, elevated dome shape spanning 6-8 MHz
+}  // namespace
+
+void ScannerAppView::refresh_display() {
+    TextLine line;
     
-    if (end_bin <= start_bin || (end_bin - start_bin) < 10) {
-        return false;  // Too narrow to analyze
+    auto& slot = scheduler.current();
+    if (is_scanning && slot.range_index < scan_ranges.size()) {
+        line.append("Range: ").append(scan_ranges[slot.range_index].name.c_str());
+        show_line(text_current_range, shown_range, line);
+        
+        // Show chunk progress (e.g., "5800 MHz [3/10]"), revisits of active chunks as "[R 3/10]"
+        line.clear().append("Chunk: ").append_uint(slot.center / 1000000).append(" MHz [");
+        if (slot.revisit) line.append("R ");
+        line.append_uint(slot.chunk_index + 1).append('/').append_uint(slot.chunk_count).append(']');
+        show_line(text_current_freq, shown_chunk, line);
     }
     
-    // Calculate center and edges
-    size_t center_bin = (start_bin + end_bin) / 2;
-    size_t quarter_point = start_bin + (end_bin - start_bin) / 4;
-    size_t three_quarter = start_bin + 3 * (end_bin - start_bin) / 4;
-    
-    // Get power values
-    uint8_t left_edge = spectrum.db[start_bin];
-    uint8_t left_quarter = spectrum.db[quarter_point];
-    uint8_t center = spectrum.db[center_bin];
-    uint8_t right_quarter = spectrum.db[three_quarter];
-    uint8_t right_edge = spectrum.db[end_bin];
-    
-    // Dome characteristics:
-    // 1. Center should be elevated (peak)
-    // 2. Smooth gradual slopes on both sides
-    // 3. Not spiky (not digital/noise)
+    // Max power in the last analyzed chunk
+    if (chunk_power_valid) {
+        line.clear().append("RSSI: ").append_int(raw_to_dbm(chunk_max_power)).append(" dBm (");
+        line.append_uint(chunk_max_power).append(')');
+        show_line(text_rssi, shown_rssi, line);
+    }
     
-    // Check if center is elevated
-    uint8_t avg_edge = (left_edge + right_edge) / 2;
-    bool peak_is_elevated = (center > avg_edge + 10);  // Center at least 10 units higher
+    line.clear().append("Widest: ");
+    if (widest_signal_width > 0) {
+        line.append_uint(widest_signal_width / 1000000).append(" MHz @ ").append_mhz(widest_signal_freq);
+    } else {
+        line.append("---");
+    }
+    show_line(text_widest, shown_widest, line);
     
-    // Check for smooth dome (quarter points between edges and center)
-    bool left_slope_smooth = (left_quarter > left_edge) && (left_quarter < center);
-    bool right_slope_smooth = (right_quarter > right_edge) && (right_quarter < center);
+    // With the strongest threat, the one to look for
+    line.clear().append("FPV Threats: ").append_uint(dome_signals_count);
+    if (auto threat = emitters.strongest_threat()) {
+        line.append(' ').append_mhz(threat->peak_freq).append(' ').append_int(threat->peak_rssi).append("dBm");
+    }
+    show_line(text_dome_signals, shown_threats, line);
     
-    // Check symmetry (dome should be roughly symmetric)
-    int32_t left_slope = left_quarter - left_edge;
-    int32_t right_slope = right_quarter - right_edge;
-    bool roughly_symmetric = std::abs(left_slope - right_slope) < 30;
+    show_line(text_status, shown_status, status_line);
     
-    // FM video dome detected if all criteria met
-    return peak_is_elevated && left_slope_smooth && right_slope_smooth && roughly_symmetric;
+    // Cycle time scales with the frames spent per chunk (settle + dwell)
+    line.clear();
+    if (last_cycle_ms == 0) {
+        line.append("--- ms/cycle");
+    } else {
+        line.append('~').append_uint(last_cycle_ms * (settle_frames + dwell_frames) / last_cycle_frames_per_chunk);
+        line.append(" ms/cycle");
+    }
+    show_line(text_cycle_time, shown_cycle_time, line);
+}
+
+void ScannerAppView::play_alert_tone() {
+    // Play 1000 Hz beep for 200ms to alert user of FPV signal detection
+    baseband::request_audio_beep(1000, 24000, 200);
+}
+
+void ScannerAppView::stop_alert_tone() {
+    baseband::request_beep_stop();
 }
 
 void initialize_app(ui::NavigationView& nav) {
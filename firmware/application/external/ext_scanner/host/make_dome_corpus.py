@@ -0,0 +1,204 @@
+#!/usr/bin/env python3
+# Labeled synthetic corpus for host/scanner_dome_bench.cpp.
+#
+# Writes <prefix>.SWR (sweep recording, see scanner_recording.hpp) and <prefix>.csv with
+# one line per signal: frame,center_hz,width_hz,class. Every signal lies inside the kept
+# bins of its frame. Classes:
+#   dome     FM video, 6-12 MHz Carson bandwidth: the averaged periodogram of a carrier
+#            frequency modulated by synthetic composite video (line sync pulses plus
+#            low-pass picture noise). The shape comes out of the modulation, not from the
+#            dome templates the classifier correlates with.
+#   ofdm     Digital flat top with steep skirts and ripple, 4-10 MHz
+#   burst    Irregular plateau (random walk), 4-10 MHz
+#   comb     Several narrow carriers on a raised pedestal, 4-10 MHz
+#   ramp     Sloped shoulder that drops off at one side, 4-10 MHz
+#
+# Usage: make_dome_corpus.py <prefix> [frames] [seed]
+
+import cmath
+import math
+import random
+import struct
+import sys
+
+BINS = 256
+SLICE_WIDTH = 20000000
+BIN_WIDTH = SLICE_WIDTH / BINS
+OVERLAP_BINS = 8
+RAW_PER_DB = 255 / 120
+NOISE_RAW = 60
+NOISE_SPREAD = 4
+
+
+def db_to_raw(db):
+    return db * RAW_PER_DB
+
+
+FFT_SEGMENTS = 16  # Periodograms averaged per dome, 205 us of signal
+LINE_SAMPLES = 1280  # 64 us video line at the 20 MHz sample rate
+SYNC_SAMPLES = 94    # 4.7 us sync pulse
+
+
+def fft(x):
+    # Iterative radix-2, len(x) a power of two
+    n = len(x)
+    x = list(x)
+    j = 0
+    for i in range(1, n):
+        bit = n >> 1
+        while j & bit:
+            j ^= bit
+            bit >>= 1
+        j |= bit
+        if i < j:
+            x[i], x[j] = x[j], x[i]
+    size = 2
+    while size <= n:
+        step = cmath.exp(-2j * math.pi / size)
+        for start in range(0, n, size):
+            w = 1
+            for k in range(size // 2):
+                a = x[start + k]
+                b = x[start + k + size // 2] * w
+                x[start + k] = a + b
+                x[start + k + size // 2] = a - b
+                w *= step
+        size *= 2
+    return x
+
+
+def composite_video(samples, video_bw, rng):
+    # Picture: Gaussian noise through two one-pole low-pass stages, on top of a random
+    # brightness; sync pulses drop to -1 once per line
+    a = math.exp(-2 * math.pi * video_bw / SLICE_WIDTH)
+    brightness = rng.uniform(-0.2, 0.5)
+    contrast = rng.uniform(0.2, 0.6)
+    line_start = rng.randrange(LINE_SAMPLES)
+    s1 = s2 = 0.0
+    video = []
+    for n in range(samples):
+        s1 = a * s1 + (1 - a) * rng.gauss(0, 1)
+        s2 = a * s2 + (1 - a) * s1
+        if (n + line_start) % LINE_SAMPLES < SYNC_SAMPLES:
+            video.append(-1.0)
+        else:
+            level = brightness + contrast * s2 * math.sqrt(2 * SLICE_WIDTH / video_bw)
+            video.append(max(-0.7, min(1.0, level)))
+    return video
+
+
+def dome(bins, center, width, rng):
+    # Carson: width = 2 * (peak deviation + video bandwidth)
+    video_bw = rng.uniform(0.15, 0.35) * width * BIN_WIDTH
+    deviation = width * BIN_WIDTH / 2 - video_bw
+    offset = (center - BINS / 2) * BIN_WIDTH
+
+    video = composite_video(FFT_SEGMENTS * BINS, video_bw, rng)
+    phase = 0.0
+    window = [0.5 - 0.5 * math.cos(2 * math.pi * i / BINS) for i in range(BINS)]
+    power = [0.0] * BINS
+    for segment in range(FFT_SEGMENTS):
+        x = []
+        for i in range(BINS):
+            n = segment * BINS + i
+            phase += 2 * math.pi * (offset + deviation * video[n]) / SLICE_WIDTH
+            x.append(cmath.exp(1j * phase) * window[i])
+        spectrum = fft(x)
+        for i in range(BINS):
+            # Bin 0 is -SLICE_WIDTH / 2, as on the device
+            power[i] += abs(spectrum[(i + BINS // 2) % BINS]) ** 2
+
+    # Peak snr dB over the noise, summed in linear power with it
+    peak = max(power)
+    snr = 10 ** (rng.uniform(8, 40) / 10)
+    for i in range(BINS):
+        noise = 10 ** ((bins[i] - NOISE_RAW) / RAW_PER_DB / 10)
+        bins[i] = NOISE_RAW + db_to_raw(10 * math.log10(noise + snr * power[i] / peak))
+
+
+def ofdm(bins, center, width, rng):
+    snr = db_to_raw(rng.uniform(8, 40))
+    phase = rng.uniform(0, 6.3)
+    for i in range(len(bins)):
+        d = abs(i - center) - width / 2
+        if d < 2:
+            skirt = 1 if d < 0 else 1 - (d + 1) / 3
+            ripple = db_to_raw(1.5) * math.sin(phase + i * 0.7)
+            bins[i] = max(bins[i], NOISE_RAW + snr * skirt + ripple + rng.gauss(0, 2))
+
+
+def burst(bins, center, width, rng):
+    level = db_to_raw(rng.uniform(10, 35))
+    for i in range(int(center - width / 2), int(center + width / 2)):
+        level = max(db_to_raw(6), level + rng.gauss(0, db_to_raw(2)))
+        bins[i] = max(bins[i], NOISE_RAW + level)
+
+
+def comb(bins, center, width, rng):
+    pedestal = db_to_raw(rng.uniform(5, 10))
+    start = int(center - width / 2)
+    for i in range(start, int(center + width / 2)):
+        bins[i] = max(bins[i], NOISE_RAW + pedestal + rng.gauss(0, 2))
+    for _ in range(rng.randint(2, 5)):
+        carrier = rng.randint(start, int(center + width / 2) - 1)
+        bins[carrier] = max(bins[carrier], NOISE_RAW + db_to_raw(rng.uniform(20, 40)))
+
+
+def ramp(bins, center, width, rng):
+    snr = db_to_raw(rng.uniform(10, 40))
+    rising = rng.random() < 0.5
+    start = int(center - width / 2)
+    for i in range(start, int(center + width / 2)):
+        t = (i - start) / width
+        level = snr * (t if rising else 1 - t)
+        bins[i] = max(bins[i], NOISE_RAW + db_to_raw(6) + level + rng.gauss(0, 2))
+
+
+SHAPES = {
+    "dome": (dome, 6e6, 12e6),
+    "ofdm": (ofdm, 4e6, 10e6),
+    "burst": (burst, 4e6, 10e6),
+    "comb": (comb, 4e6, 10e6),
+    "ramp": (ramp, 4e6, 10e6),
+}
+
+
+def main():
+    if len(sys.argv) < 2:
+        sys.exit("Usage: make_dome_corpus.py <prefix> [frames] [seed]")
+    prefix = sys.argv[1]
+    frames = int(sys.argv[2]) if len(sys.argv) > 2 else 2000
+    rng = random.Random(int(sys.argv[3]) if len(sys.argv) > 3 else 1)
+
+    step = (BINS - 2 * OVERLAP_BINS) * BIN_WIDTH
+    with open(prefix + ".SWR", "wb") as swr, open(prefix + ".csv", "w") as csv:
+        swr.write(b"SWRC" + struct.pack("<HHIHH", 2, BINS, SLICE_WIDTH, OVERLAP_BINS, 0))
+        csv.write("frame,center_hz,width_hz,class\n")
+
+        for frame in range(frames):
+            center_freq = int(1000e6 + frame * step)
+            bins = [NOISE_RAW + rng.uniform(-NOISE_SPREAD, NOISE_SPREAD) for _ in range(BINS)]
+
+            # One or two signals, half of the frames have a dome
+            kinds = ["dome" if rng.random() < 0.5 else rng.choice(list(SHAPES)[1:])]
+            if rng.random() < 0.3:
+                kinds.append(rng.choice(list(SHAPES)[1:]))
+
+            low = OVERLAP_BINS + 2
+            for kind in kinds:
+                shape, min_width, max_width = SHAPES[kind]
+                width = rng.uniform(min_width, max_width) / BIN_WIDTH
+                center = rng.uniform(low + width / 2, BINS - OVERLAP_BINS - 2 - width / 2)
+                if center - width / 2 < low or center + width / 2 > BINS - OVERLAP_BINS - 2:
+                    continue
+                shape(bins, center, width, rng)
+                low = int(center + width / 2) + 4
+                freq = center_freq - SLICE_WIDTH / 2 + center * BIN_WIDTH
+                csv.write("%d,%d,%d,%s\n" % (frame, freq, width * BIN_WIDTH, kind))
+
+            raw = bytes(max(0, min(255, int(round(v)))) for v in bins)
+            swr.write(struct.pack("<Q", center_freq) + raw)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,311 @@
+// Host benchmark of the FM video dome classifiers on a labeled corpus:
+// the template correlation (scanner_dome.cpp) against the original five-point test.
+//
+// Build on Linux (from this directory):
+//   g++ -std=c++17 -O2 -I.. ../scanner_*.cpp scanner_dome_bench.cpp -o scanner_dome_bench
+//
+// Usage:
+//   ./make_dome_corpus.py corpus
+//   scanner_dome_bench corpus.SWR corpus.csv [-t dBm] [-min MHz] [-max MHz] [-c confidence] [-r repeats]
+//
+// Every run with a width inside BW Min/BW Max is classified, as the detector would.
+// A run belongs to the labeled signal containing its center, or to "noise" if none does.
+
+#include "scanner_detector.hpp"
+#include "scanner_bin_kernel.hpp"
+#include "scanner_dome.hpp"
+#include "scanner_recording.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace ui::external_app::ext_scanner;
+
+namespace {
+
+struct Options {
+    const char* recording_path = nullptr;
+    const char* labels_path = nullptr;
+    DetectorConfig config{};
+    uint32_t repeats = 100;
+};
+
+struct Label {
+    size_t frame;
+    Frequency center;
+    Frequency width;
+    std::string kind;
+};
+
+struct Run {
+    const uint8_t* kept;  // Kept bins of the frame
+    size_t kept_count;
+    size_t start_bin;     // In kept
+    size_t end_bin;
+    std::string kind;
+};
+
+struct Score {
+    uint32_t dome = 0;  // Runs called a dome
+    uint32_t total = 0;
+};
+
+void print_usage(const char* argv0) {
+    std::fprintf(stderr,
+                 "Usage: %s <corpus.SWR> <corpus.csv> [-t dBm] [-min MHz] [-max MHz] [-c confidence] [-r repeats]\n",
+                 argv0);
+}
+
+bool parse_options(int argc, char** argv, Options& options) {
+    options.config.squelch_threshold = -85;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const bool has_value = (i + 1 < argc);
+
+        if (std::strcmp(arg, "-t") == 0 && has_value) {
+            options.config.squelch_threshold = std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "-min") == 0 && has_value) {
+            options.config.min_signal_width_mhz = std::min<uint32_t>(std::atoi(argv[++i]), SpectrumDetector::MAX_SIGNAL_WIDTH_MHZ);
+        } else if (std::strcmp(arg, "-max") == 0 && has_value) {
+            options.config.max_signal_width_mhz = std::min<uint32_t>(std::atoi(argv[++i]), SpectrumDetector::MAX_SIGNAL_WIDTH_MHZ);
+        } else if (std::strcmp(arg, "-c") == 0 && has_value) {
+            options.config.min_dome_confidence = std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "-r") == 0 && has_value) {
+            options.repeats = std::atoi(argv[++i]);
+        } else if (arg[0] != '-' && !options.recording_path) {
+            options.recording_path = arg;
+        } else if (arg[0] != '-' && !options.labels_path) {
+            options.labels_path = arg;
+        } else {
+            return false;
+        }
+    }
+    return options.recording_path && options.labels_path && options.repeats > 0;
+}
+
+bool load_recording(const char* path, SweepRecordingHeader& header, std::vector<SweepRecordingFrame>& frames) {
+    FILE* file = std::fopen(path, "rb");
+    if (!file) {
+        std::fprintf(stderr, "Can't open %s\n", path);
+        return false;
+    }
+
+    bool ok = std::fread(&header, sizeof(header), 1, file) == 1 && header.is_valid();
+    if (!ok) {
+        std::fprintf(stderr, "%s: not a sweep recording\n", path);
+    }
+
+    SweepRecordingFrame frame;
+    while (ok && std::fread(&frame, sizeof(frame), 1, file) == 1) {
+        frames.push_back(frame);
+    }
+
+    std::fclose(file);
+    return ok;
+}
+
+bool load_labels(const char* path, std::multimap<size_t, Label>& labels) {
+    FILE* file = std::fopen(path, "r");
+    if (!file) {
+        std::fprintf(stderr, "Can't open %s\n", path);
+        return false;
+    }
+
+    char line[128];
+    while (std::fgets(line, sizeof(line), file)) {
+        unsigned long frame;
+        long long center;
+        long long width;
+        char kind[32];
+        if (std::sscanf(line, "%lu,%lld,%lld,%31s", &frame, &center, &width, kind) == 4) {
+            labels.insert({frame, {frame, center, width, kind}});
+        }
+    }
+
+    std::fclose(file);
+    return true;
+}
+
+// Candidate runs of every frame, labeled
+std::vector<Run> collect_runs(const std::vector<SweepRecordingFrame>& frames,
+                              const std::multimap<size_t, Label>& labels,
+                              const DetectorConfig& config, uint32_t overlap_bins) {
+    std::vector<Run> runs;
+    FloorSegments thresholds;
+    thresholds.fill(dbm_to_raw(config.squelch_threshold));
+
+    const size_t first_bin = overlap_bins;
+    const size_t end_bin = SPECTRUM_BINS - overlap_bins;
+    const Frequency min_width = (Frequency)config.min_signal_width_mhz * 1000000;
+    const Frequency max_width = (Frequency)config.max_signal_width_mhz * 1000000;
+
+    for (size_t i = 0; i < frames.size(); i++) {
+        const auto& frame = frames[i];
+        BinScan scan;
+        scan_bins(frame.db.data(), thresholds, scan);
+
+        const Frequency kept_start = (Frequency)frame.center_freq - (SPECTRUM_SLICE_WIDTH / 2) + (Frequency)first_bin * BIN_WIDTH;
+        size_t start = next_above_bin(scan, first_bin);
+        while (start < end_bin) {
+            const size_t end = std::min(next_below_bin(scan, start + 1), end_bin);
+            const Frequency width = (Frequency)(end - start) * BIN_WIDTH;
+
+            if (width >= min_width && width <= max_width) {
+                const Frequency center = kept_start + (Frequency)(start + end - 1 - 2 * first_bin) * BIN_WIDTH / 2;
+                std::string kind = "noise";
+                auto range = labels.equal_range(i);
+                for (auto it = range.first; it != range.second; ++it) {
+                    if (std::llabs(center - it->second.center) <= it->second.width / 2) {
+                        kind = it->second.kind;
+                    }
+                }
+                runs.push_back({frame.db.data() + first_bin, end_bin - first_bin,
+                                start - first_bin, end - first_bin - 1, kind});
+            }
+            start = next_above_bin(scan, end + 1);
+        }
+    }
+    return runs;
+}
+
+template <typename Classifier>
+double run_classifier(const std::vector<Run>& runs, uint32_t repeats, std::map<std::string, Score>& scores,
+                      Classifier classifier) {
+    for (const auto& run : runs) {
+        auto& score = scores[run.kind];
+        score.total++;
+        if (classifier(run)) score.dome++;
+    }
+
+    uint32_t checksum = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (uint32_t pass = 0; pass < repeats; pass++) {
+        for (const auto& run : runs) {
+            checksum += classifier(run);
+        }
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+
+    // Keep the work observable so it isn't optimized away
+    volatile uint32_t sink = checksum;
+    (void)sink;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / ((double)runs.size() * repeats);
+}
+
+// The detector's original five-point dome test, kept here only for the comparison
+bool analyze_fm_dome_shape(const uint8_t* db, size_t start_bin, size_t end_bin) {
+    // Analyze spectrum shape to detect FM video "dome" characteristic of FPV drones
+    // FM video has a smooth, elevated dome shape spanning 6-8 MHz
+
+    if (end_bin <= start_bin || (end_bin - start_bin) < 10) {
+        return false;  // Too narrow to analyze
+    }
+
+    // Calculate center and edges
+    size_t center_bin = (start_bin + end_bin) / 2;
+    size_t quarter_point = start_bin + (end_bin - start_bin) / 4;
+    size_t three_quarter = start_bin + 3 * (end_bin - start_bin) / 4;
+
+    // Get power values
+    uint8_t left_edge = db[start_bin];
+    uint8_t left_quarter = db[quarter_point];
+    uint8_t center = db[center_bin];
+    uint8_t right_quarter = db[three_quarter];
+    uint8_t right_edge = db[end_bin];
+
+    // Dome characteristics:
+    // 1. Center should be elevated (peak)
+    // 2. Smooth gradual slopes on both sides
+    // 3. Not spiky (not digital/noise)
+
+    // Check if center is elevated
+    uint8_t avg_edge = (left_edge + right_edge) / 2;
+    bool peak_is_elevated = (center > avg_edge + 10);  // Center at least 10 units higher
+
+    // Check for smooth dome (quarter points between edges and center)
+    bool left_slope_smooth = (left_quarter > left_edge) && (left_quarter < center);
+    bool right_slope_smooth = (right_quarter > right_edge) && (right_quarter < center);
+
+    // Check symmetry (dome should be roughly symmetric)
+    int32_t left_slope = left_quarter - left_edge;
+    int32_t right_slope = right_quarter - right_edge;
+    bool roughly_symmetric = std::abs(left_slope - right_slope) < 30;
+
+    // FM video dome detected if all criteria met
+    return peak_is_elevated && left_slope_smooth && right_slope_smooth && roughly_symmetric;
+}
+
+void print_scores(const char* name, const std::map<std::string, Score>& scores, double ns) {
+    uint32_t true_positive = 0, false_negative = 0, false_positive = 0, true_negative = 0;
+    for (const auto& entry : scores) {
+        const bool is_dome = entry.first == "dome";
+        (is_dome ? true_positive : false_positive) += entry.second.dome;
+        (is_dome ? false_negative : true_negative) += entry.second.total - entry.second.dome;
+    }
+
+    std::printf("%-10s", name);
+    for (const auto& entry : scores) {
+        std::printf("  %s %u/%u", entry.first.c_str(), entry.second.dome, entry.second.total);
+    }
+    std::printf("\n%-10s  recall %.1f%%  false alarms %.1f%%  accuracy %.1f%%  %.1f ns/run\n", "",
+                100.0 * true_positive / std::max(1u, true_positive + false_negative),
+                100.0 * false_positive / std::max(1u, false_positive + true_negative),
+                100.0 * (true_positive + true_negative) /
+                    std::max(1u, true_positive + true_negative + false_positive + false_negative),
+                ns);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parse_options(argc, argv, options)) {
+        print_usage(argv[0]);
+        return 2;
+    }
+
+    SweepRecordingHeader header;
+    std::vector<SweepRecordingFrame> frames;
+    std::multimap<size_t, Label> labels;
+    if (!load_recording(options.recording_path, header, frames)) return 1;
+    if (!load_labels(options.labels_path, labels)) return 1;
+
+    const uint32_t overlap_bins = header.version >= 2 ? header.overlap_bins : 0;
+    const auto runs = collect_runs(frames, labels, options.config, overlap_bins);
+    if (runs.empty()) {
+        std::fprintf(stderr, "No runs inside BW %u-%u MHz at %d dBm\n",
+                     options.config.min_signal_width_mhz, options.config.max_signal_width_mhz,
+                     options.config.squelch_threshold);
+        return 1;
+    }
+
+    std::printf("threshold %d dBm, BW %u-%u MHz, confidence %u, %zu frames, %zu runs\n",
+                options.config.squelch_threshold,
+                options.config.min_signal_width_mhz,
+                options.config.max_signal_width_mhz,
+                options.config.min_dome_confidence,
+                frames.size(), runs.size());
+
+    // Runs of each class called a dome, per classifier
+    std::map<std::string, Score> five_point_scores;
+    const double five_point_ns = run_classifier(runs, options.repeats, five_point_scores, [](const Run& run) {
+        return analyze_fm_dome_shape(run.kept, run.start_bin, run.end_bin);
+    });
+    print_scores("five-point", five_point_scores, five_point_ns);
+
+    const uint32_t min_confidence = options.config.min_dome_confidence;
+    std::map<std::string, Score> template_scores;
+    const double template_ns = run_classifier(runs, options.repeats, template_scores, [min_confidence](const Run& run) {
+        return match_dome_template(run.kept, run.kept_count, run.start_bin, run.end_bin).confidence >= min_confidence;
+    });
+    print_scores("template", template_scores, template_ns);
+
+    return 0;
+}
@@ -0,0 +1,337 @@
+// Host-side replay of sweep recordings (.SWR) through the scanner detection core.
+//
+// Build on Linux (from this directory):
+//   g++ -std=c++17 -O2 -I.. ../scanner_*.cpp scanner_replay.cpp -o scanner_replay
+//
+// Usage:
+//   scanner_replay <file.SWR> [-t dBm] [-f dB] [-min MHz] [-max MHz] [-c confidence]
+//                  [-d frames] [-m max|mean|min] [-r repeats] [-k] [-v]
+//
+// Prints detections (with -v) and throughput: frames/sec and ns/frame.
+// -d integrates consecutive frames of the same chunk like the device's dwell setting.
+// The chunk overlap comes from the recording header.
+// Detections are merged into emitters as on the device, a wrap to the first chunk ends a cycle.
+// Counters are of one pass over the recording, -r repeats it for timing only.
+// -k also checks scan_bins() against the byte-at-a-time reference and times both.
+
+#include "scanner_detector.hpp"
+#include "scanner_bin_kernel.hpp"
+#include "scanner_dwell.hpp"
+#include "scanner_emitters.hpp"
+#include "scanner_noise_floor.hpp"
+#include "scanner_recording.hpp"
+#include "scanner_sweep.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <map>
+#include <vector>
+
+using namespace ui::external_app::ext_scanner;
+
+namespace {
+
+struct Options {
+    const char* path = nullptr;
+    DetectorConfig config{};
+    uint32_t dwell_frames = 1;
+    DwellMode dwell_mode = DwellMode::MaxHold;
+    uint32_t repeats = 1;
+    bool kernel = false;
+    bool verbose = false;
+};
+
+void print_usage(const char* argv0) {
+    std::fprintf(stderr,
+                 "Usage: %s <file.SWR> [-t dBm] [-f dB] [-min MHz] [-max MHz] [-c confidence]\n"
+                 "       [-d frames] [-m max|mean|min] [-r repeats] [-k] [-v]\n",
+                 argv0);
+}
+
+bool parse_options(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const bool has_value = (i + 1 < argc);
+
+        if (std::strcmp(arg, "-t") == 0 && has_value) {
+            options.config.squelch_threshold = std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "-f") == 0 && has_value) {
+            options.config.floor_margin_db = std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "-min") == 0 && has_value) {
+            options.config.min_signal_width_mhz = std::min<uint32_t>(std::atoi(argv[++i]), SpectrumDetector::MAX_SIGNAL_WIDTH_MHZ);
+        } else if (std::strcmp(arg, "-max") == 0 && has_value) {
+            options.config.max_signal_width_mhz = std::min<uint32_t>(std::atoi(argv[++i]), SpectrumDetector::MAX_SIGNAL_WIDTH_MHZ);
+        } else if (std::strcmp(arg, "-c") == 0 && has_value) {
+            options.config.min_dome_confidence = std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "-d") == 0 && has_value) {
+            options.dwell_frames = std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "-m") == 0 && has_value) {
+            const char* mode = argv[++i];
+            if (std::strcmp(mode, "max") == 0) {
+                options.dwell_mode = DwellMode::MaxHold;
+            } else if (std::strcmp(mode, "mean") == 0) {
+                options.dwell_mode = DwellMode::Mean;
+            } else if (std::strcmp(mode, "min") == 0) {
+                options.dwell_mode = DwellMode::Min;
+            } else {
+                return false;
+            }
+        } else if (std::strcmp(arg, "-r") == 0 && has_value) {
+            options.repeats = std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "-k") == 0) {
+            options.kernel = true;
+        } else if (std::strcmp(arg, "-v") == 0) {
+            options.verbose = true;
+        } else if (arg[0] != '-' && !options.path) {
+            options.path = arg;
+        } else {
+            return false;
+        }
+    }
+    return options.path && options.repeats > 0;
+}
+
+bool load_recording(const char* path, SweepRecordingHeader& header, std::vector<SweepRecordingFrame>& frames) {
+    FILE* file = std::fopen(path, "rb");
+    if (!file) {
+        std::fprintf(stderr, "Can't open %s\n", path);
+        return false;
+    }
+
+    bool ok = std::fread(&header, sizeof(header), 1, file) == 1 && header.is_valid();
+    if (!ok) {
+        std::fprintf(stderr, "%s: not a v%u sweep recording\n", path, SWEEP_RECORDING_VERSION);
+    }
+
+    SweepRecordingFrame frame;
+    while (ok && std::fread(&frame, sizeof(frame), 1, file) == 1) {
+        frames.push_back(frame);
+    }
+
+    std::fclose(file);
+    return ok;
+}
+
+template <typename Kernel>
+double time_kernel(const std::vector<SweepRecordingFrame>& frames, uint32_t repeats, Kernel kernel) {
+    FloorSegments thresholds;
+    thresholds.fill(dbm_to_raw(DetectorConfig{}.squelch_threshold));
+    BinScan scan;
+    uint32_t checksum = 0;
+
+    const auto start = std::chrono::steady_clock::now();
+    for (uint32_t pass = 0; pass < repeats; pass++) {
+        for (const auto& frame : frames) {
+            kernel(frame.db.data(), thresholds, scan);
+            checksum += scan.max_power + scan.above[0];
+        }
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+
+    // Keep the work observable so it isn't optimized away
+    volatile uint32_t sink = checksum;
+    (void)sink;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / ((double)frames.size() * repeats);
+}
+
+bool check_kernel(const std::vector<SweepRecordingFrame>& frames, uint32_t repeats) {
+    FloorSegments thresholds;
+    BinScan scan;
+    BinScan reference;
+
+    // Every frame against a spread of thresholds
+    for (const auto& frame : frames) {
+        for (int32_t threshold = 0; threshold <= RAW_MAX; threshold += 15) {
+            for (size_t segment = 0; segment < FLOOR_SEGMENTS; segment++) {
+                thresholds[segment] = (threshold + segment * 7) & 0xFF;
+            }
+            scan_bins(frame.db.data(), thresholds, scan);
+            scan_bins_reference(frame.db.data(), thresholds, reference);
+
+            if (scan.max_power != reference.max_power ||
+                scan.segment_mean != reference.segment_mean ||
+                scan.above != reference.above) {
+                std::printf("kernel      MISMATCH at %llu Hz, threshold %d\n",
+                            (unsigned long long)frame.frequency(), threshold);
+                return false;
+            }
+        }
+    }
+
+    const double kernel_ns = time_kernel(frames, repeats, scan_bins);
+    const double reference_ns = time_kernel(frames, repeats, scan_bins_reference);
+    std::printf("kernel      %.1f ns/frame (reference %.1f ns/frame, %.1fx)\n",
+                kernel_ns, reference_ns, reference_ns / kernel_ns);
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parse_options(argc, argv, options)) {
+        print_usage(argv[0]);
+        return 2;
+    }
+
+    SweepRecordingHeader header;
+    std::vector<SweepRecordingFrame> frames;
+    if (!load_recording(options.path, header, frames)) return 1;
+    options.config.overlap_bins = header.version >= 2 ? header.overlap_bins : 0;
+    if (frames.empty()) {
+        std::fprintf(stderr, "%s: no frames\n", options.path);
+        return 1;
+    }
+
+    // Chunk ids in order of first appearance, as the device numbers its linear sweep.
+    // Version 3 flags revisits, which may be tuned off their chunk center: they take the id
+    // of the nearest linear center and the floor shifted by the same number of segments.
+    const bool flags_revisits = header.version >= 3;
+    std::map<uint64_t, size_t> ids_by_center;
+    for (const auto& frame : frames) {
+        if (!flags_revisits || !frame.is_revisit()) {
+            ids_by_center.emplace(frame.frequency(), ids_by_center.size());
+        }
+    }
+
+    std::vector<size_t> chunk_ids;
+    std::vector<int32_t> shifts;
+    for (const auto& frame : frames) {
+        const uint64_t freq = frame.frequency();
+        auto it = ids_by_center.lower_bound(freq);
+        if (it == ids_by_center.end() || (it != ids_by_center.begin() && freq - std::prev(it)->first < it->first - freq)) {
+            if (it == ids_by_center.begin()) {
+                std::fprintf(stderr, "%s: revisit with no linear frames\n", options.path);
+                return 1;
+            }
+            --it;
+        }
+        const int64_t offset = (int64_t)freq - (int64_t)it->first;
+        chunk_ids.push_back(it->second);
+        shifts.push_back((offset + (offset < 0 ? -1 : 1) * FLOOR_SEGMENT_WIDTH / 2) / FLOOR_SEGMENT_WIDTH);
+    }
+
+    SpectrumDetector detector;
+    detector.set_config(options.config);
+    NoiseFloorModel noise_floor;
+    DwellAccumulator dwell;
+    dwell.configure(options.dwell_frames, options.dwell_mode);
+    EmitterTracker emitters;
+
+    uint64_t detections = 0;
+    uint64_t domes = 0;
+    uint64_t overflow = 0;
+    uint64_t analyzed = 0;
+    uint64_t revisits = 0;
+    uint64_t cycles = 0;         // All counters are of the first pass, repeats only add timing
+    uint64_t new_emitters = 0;   // Counted as they are created, even if evicted later
+    uint32_t dome_emitters = 0;
+
+    const auto start = std::chrono::steady_clock::now();
+    for (uint32_t pass = 0; pass < options.repeats; pass++) {
+        detector.reset();
+        noise_floor.clear();
+        dwell.reset();
+        emitters.clear();
+        size_t last_linear_id = 0;
+        bool first_frame = true;
+        for (size_t i = 0; i < frames.size(); i++) {
+            const auto& frame = frames[i];
+
+            // A chunk change mid-dwell means the recording has an incomplete group
+            if (i > 0 && frame.center_freq != frames[i - 1].center_freq) {
+                dwell.reset();
+            }
+            if (!dwell.add(frame.db.data())) continue;
+
+            // The device sweeps chunk ids in order and wraps after the last one; anything
+            // else is a revisit, which the detector must see as out of sweep order
+            const size_t id = chunk_ids[i];
+            const bool in_sweep_order = flags_revisits
+                                            ? !frame.is_revisit()
+                                            : first_frame || id == last_linear_id + 1 ||
+                                                  (id == 0 && last_linear_id + 1 == ids_by_center.size());
+            if (in_sweep_order) {
+                if (id == 0 && !first_frame) {
+                    emitters.end_cycle();
+                    if (pass == 0) cycles++;
+                }
+                last_linear_id = id;
+            } else if (pass == 0) {
+                revisits++;
+            }
+            first_frame = false;
+
+            FloorSegments shifted;
+            const auto& result = detector.process_frame(frame.frequency(), dwell.frame(), in_sweep_order,
+                                                        noise_floor.shifted_floor(id, shifts[i], options.config.overlap_bins,
+                                                                                  shifted));
+            if (shifts[i] == 0) {
+                noise_floor.update(id, result.segment_mean);
+            }
+            if (pass > 0) {
+                // Same work as the first pass, only counted there
+                for (size_t d = 0; d < result.detection_count; d++) {
+                    emitters.update(result.detections[d], i);
+                }
+                continue;
+            }
+
+            analyzed++;
+            detections += result.detection_count;
+            overflow += result.overflow_count;
+            for (size_t d = 0; d < result.detection_count; d++) {
+                const auto& detection = result.detections[d];
+                if (detection.has_video_dome) domes++;
+
+                // Recordings carry no timestamps, frame numbers stand in for milliseconds
+                const auto update = emitters.update(detection, i);
+                if (update == EmitterTracker::Update::NewEmitter || update == EmitterTracker::Update::NewThreat) {
+                    new_emitters++;
+                }
+
+                if (options.verbose) {
+                    std::printf("frame %6zu  %10.3f MHz  %5.2f MHz  %4d dBm  %3u%%%s\n",
+                                i, detection.freq / 1e6, detection.width / 1e6, detection.rssi,
+                                detection.dome_confidence, detection.has_video_dome ? "  DOME" : "");
+                }
+            }
+        }
+
+        // The last cycle ends with the recording
+        emitters.end_cycle();
+        if (pass == 0) {
+            cycles++;
+            dome_emitters = emitters.threat_count();
+        }
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+
+    const uint64_t total_frames = (uint64_t)frames.size() * options.repeats;
+    const double ns = std::chrono::duration<double, std::nano>(elapsed).count();
+
+    std::printf("threshold %d dBm, floor +%d dB, BW %u-%u MHz, overlap %u bins, dome %u%%\n",
+                options.config.squelch_threshold,
+                options.config.floor_margin_db,
+                options.config.min_signal_width_mhz,
+                options.config.max_signal_width_mhz,
+                options.config.overlap_bins,
+                options.config.min_dome_confidence);
+    std::printf("frames      %llu (%zu x %u), %llu analyzed with dwell %u, %llu revisits\n",
+                (unsigned long long)total_frames, frames.size(), options.repeats,
+                (unsigned long long)analyzed, dwell.frames(), (unsigned long long)revisits);
+    std::printf("detections  %llu (%llu dome, %llu over the per-frame limit)\n",
+                (unsigned long long)detections, (unsigned long long)domes, (unsigned long long)overflow);
+    std::printf("emitters    %llu in %llu cycles (%u dome)\n",
+                (unsigned long long)new_emitters, (unsigned long long)cycles, dome_emitters);
+    std::printf("ns/frame    %.1f\n", ns / total_frames);
+    std::printf("frames/sec  %.0f\n", total_frames / (ns / 1e9));
+
+    if (options.kernel && !check_kernel(frames, options.repeats)) return 1;
+
+    return 0;
+}
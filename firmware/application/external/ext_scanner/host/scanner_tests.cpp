@@ -0,0 +1,235 @@
+// Host-side tests of the scanner detection core on synthetic spectra.
+//
+// Build on Linux (from this directory):
+//   g++ -std=c++17 -O2 -I.. ../scanner_*.cpp scanner_tests.cpp -o scanner_tests
+//
+// Usage:
+//   scanner_tests
+//
+// Prints each failed check and exits non-zero if there was one.
+
+#include "scanner_detector.hpp"
+#include "scanner_emitters.hpp"
+#include "scanner_noise_floor.hpp"
+#include "scanner_sweep.hpp"
+
+#include <cstdio>
+#include <vector>
+
+using namespace ui::external_app::ext_scanner;
+
+namespace {
+
+int failures = 0;
+
+#define CHECK(condition)                                                              \
+    do {                                                                              \
+        if (!(condition)) {                                                           \
+            std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            failures++;                                                               \
+        }                                                                             \
+    } while (0)
+
+constexpr Frequency MHZ = 1000000;
+
+// FM video dome: a parabola in dB, width_mhz wide where it crosses edge_dbm
+struct Dome {
+    Frequency center;
+    int32_t width_mhz;
+    int32_t peak_dbm;
+    int32_t edge_dbm;
+};
+
+// One frame tuned to center: deterministic noise around noise_dbm plus the domes
+void render_frame(Frequency center, const std::vector<Dome>& domes, int32_t noise_dbm, uint8_t* db) {
+    uint32_t seed = (uint32_t)(center / 1000);
+    for (size_t bin = 0; bin < SPECTRUM_BINS; bin++) {
+        seed = seed * 1103515245 + 12345;
+        double dbm = noise_dbm + (int32_t)((seed >> 16) % 5) - 2;
+
+        const Frequency freq = center - SPECTRUM_SLICE_WIDTH / 2 + (Frequency)bin * BIN_WIDTH;
+        for (const auto& dome : domes) {
+            const double t = 2.0 * (freq - dome.center) / (dome.width_mhz * MHZ);
+            const double dome_dbm = dome.peak_dbm - (dome.peak_dbm - dome.edge_dbm) * t * t;
+            if (dome_dbm > dbm) dbm = dome_dbm;
+        }
+        db[bin] = dbm_to_raw((int32_t)dbm);
+    }
+}
+
+// A 6 MHz dome centered exactly on the edge between the kept bins of two chunks is only
+// whole in the stitched spectrum. The revisit must be tuned onto it, so the second sighting
+// confirms it before the cycle ends.
+void test_dome_on_chunk_edge() {
+    const Frequency edge = 5800 * MHZ;
+    std::vector<FrequencyRange> ranges{{edge - 2 * chunk_step(DEFAULT_OVERLAP_BINS), edge + 8 * chunk_step(DEFAULT_OVERLAP_BINS)}};
+    const std::vector<Dome> domes{{edge, 6, -55, -85}};
+
+    DetectorConfig config;
+    config.squelch_threshold = -85;
+    SpectrumDetector detector;
+    detector.set_config(config);
+
+    RevisitScheduler scheduler(ranges);
+    CHECK(scheduler.start());
+
+    uint8_t db[SPECTRUM_BINS];
+    size_t linear_domes = 0;
+    size_t revisit_domes = 0;
+    bool confirmed = false;
+    bool cycle_complete = false;
+
+    while (!confirmed && !cycle_complete) {
+        const ChunkSlot slot = scheduler.current();
+        cycle_complete = scheduler.advance();
+
+        render_frame(slot.center, domes, -110, db);
+        const auto& result = detector.process_frame(slot.center, db, !slot.revisit);
+        for (size_t i = 0; i < result.detection_count; i++) {
+            const auto& detection = result.detections[i];
+            if (!detection.has_video_dome) continue;
+            CHECK(detection.center > edge - MHZ && detection.center < edge + MHZ);
+            (slot.revisit ? revisit_domes : linear_domes)++;
+        }
+        confirmed = scheduler.report(slot, result.max_power, result.detections.data(), result.detection_count);
+    }
+
+    CHECK(linear_domes == 1);
+    CHECK(revisit_domes == 1);
+    CHECK(confirmed);
+    CHECK(!cycle_complete);
+}
+
+// Two domes credited to one chunk in the same frame (adjacent channels, or one dome split
+// by a dip) are still a single sighting; only a later visit confirms
+void test_two_domes_in_one_frame_need_a_revisit() {
+    std::vector<FrequencyRange> ranges{{5700 * MHZ, 5900 * MHZ}};
+    RevisitScheduler scheduler(ranges);
+    CHECK(scheduler.start());
+
+    const ChunkSlot slot = scheduler.current();
+    const Detection domes[2] = {
+        {slot.center - 4 * MHZ, slot.center - 4 * MHZ, 6 * MHZ, -60, true, 95},
+        {slot.center + 4 * MHZ, slot.center + 4 * MHZ, 6 * MHZ, -60, true, 95},
+    };
+    CHECK(!scheduler.report(slot, RAW_MAX, domes, 2));
+    CHECK(scheduler.report(slot, RAW_MAX, domes, 1));
+}
+
+// The peak of an FM video dome wanders with the picture by a couple of MHz either way;
+// frames of one hovering drone must still be one emitter and one threat
+void test_wandering_peak_is_one_emitter() {
+    const Frequency center = 5800 * MHZ;
+    const std::vector<Dome> domes{{center, 8, -55, -85}};
+
+    DetectorConfig config;
+    config.squelch_threshold = -85;
+    config.max_signal_width_mhz = 12;
+    SpectrumDetector detector;
+    detector.set_config(config);
+    EmitterTracker emitters;
+    emitters.clear();
+
+    uint8_t db[SPECTRUM_BINS];
+    const int32_t peak_offsets_khz[] = {-2420, 2030, -1500, 0, 1800, -2200, 900, 2000, -700, -2400};
+    size_t dome_frames = 0;
+    size_t new_entries = 0;
+    Frequency min_peak = center;
+    Frequency max_peak = center;
+
+    for (size_t frame = 0; frame < sizeof(peak_offsets_khz) / sizeof(peak_offsets_khz[0]); frame++) {
+        // Sync tip line or picture carrier standing out of the dome
+        render_frame(center, domes, -110, db);
+        const size_t peak_bin = SPECTRUM_BINS / 2 + peak_offsets_khz[frame] * 1000 / BIN_WIDTH;
+        db[peak_bin] = dbm_to_raw(-50);
+
+        detector.reset();  // Every frame on its own, as on separate cycles
+        const auto& result = detector.process_frame(center, db);
+        for (size_t i = 0; i < result.detection_count; i++) {
+            const auto& detection = result.detections[i];
+            if (!detection.has_video_dome) continue;
+            dome_frames++;
+            if (detection.freq < min_peak) min_peak = detection.freq;
+            if (detection.freq > max_peak) max_peak = detection.freq;
+
+            const auto update = emitters.update(detection, frame);
+            if (update == EmitterTracker::Update::NewEmitter || update == EmitterTracker::Update::NewThreat) {
+                new_entries++;
+            }
+        }
+        emitters.end_cycle();
+    }
+
+    CHECK(dome_frames == 10);
+    CHECK(max_peak - min_peak > 4 * MHZ);  // The peaks really did wander
+    CHECK(new_entries == 1);
+    CHECK(emitters.threat_count() == 1);
+
+    // A second drone one channel over is still its own threat
+    render_frame(center + 20 * MHZ, {{center + 20 * MHZ, 8, -55, -85}}, -110, db);
+    detector.reset();
+    const auto& result = detector.process_frame(center + 20 * MHZ, db);
+    CHECK(result.detection_count == 1 && result.detections[0].has_video_dome);
+    if (result.detection_count == 1) {
+        CHECK(emitters.update(result.detections[0], 10) == EmitterTracker::Update::NewThreat);
+    }
+    CHECK(emitters.threat_count() == 2);
+}
+
+// Detections are credited to the chunk whose kept bins hold them, across range gaps
+void test_locate_frequency() {
+    std::vector<FrequencyRange> ranges{{5000 * MHZ, 5030 * MHZ}, {5100 * MHZ, 5130 * MHZ}};
+    ChunkSequencer sequencer(ranges);
+    CHECK(sequencer.start());
+
+    const Frequency step = chunk_step(DEFAULT_OVERLAP_BINS);
+    ChunkSlot slot;
+    CHECK(sequencer.locate_frequency(5000 * MHZ, slot) && slot.chunk_id == 0);
+    CHECK(sequencer.locate_frequency(5000 * MHZ + step, slot) && slot.chunk_id == 1);
+    CHECK(sequencer.locate_frequency(5100 * MHZ + step - 1, slot) && slot.chunk_id == 2);
+    CHECK(sequencer.locate_frequency(5100 * MHZ + step, slot) && slot.chunk_id == 3);
+    CHECK(!sequencer.locate_frequency(5050 * MHZ, slot));
+    CHECK(!sequencer.locate_frequency(4999 * MHZ, slot));
+}
+
+// The floor follows a step up in the real noise floor larger than RISE_LIMIT, and a
+// short burst of the same size barely moves it
+void test_floor_recovers_from_step_up() {
+    NoiseFloorModel model;
+    FloorSegments low;
+    low.fill(dbm_to_raw(-110));
+    FloorSegments high;
+    high.fill(low[0] + 3 * NoiseFloorModel::RISE_LIMIT);
+
+    model.update(0, low);
+    for (size_t frame = 0; frame < NoiseFloorModel::RECOVERY_INTERVAL - 1; frame++) {
+        model.update(0, high);
+    }
+    CHECK(model.floor(0) && (*model.floor(0))[0] == low[0]);
+
+    // Up to RISE_LIMIT below it the floor creeps up once per RECOVERY_INTERVAL, then tracks
+    const size_t frames = NoiseFloorModel::RECOVERY_INTERVAL * 2 * NoiseFloorModel::RISE_LIMIT +
+                          NoiseFloorModel::RISE_LIMIT;
+    for (size_t frame = 0; frame < frames; frame++) {
+        model.update(0, high);
+    }
+    CHECK((*model.floor(0))[0] == high[0]);
+    CHECK((*model.floor(0))[FLOOR_SEGMENTS - 1] == high[0]);
+}
+
+}  // namespace
+
+int main() {
+    test_dome_on_chunk_edge();
+    test_two_domes_in_one_frame_need_a_revisit();
+    test_locate_frequency();
+    test_floor_recovers_from_step_up();
+    test_wandering_peak_is_one_emitter();
+
+    if (failures) {
+        std::printf("%d checks failed\n", failures);
+        return 1;
+    }
+    std::printf("all tests passed\n");
+    return 0;
+}
@@ -0,0 +1,119 @@
+#include "scanner_bin_kernel.hpp"
+#include <cstring>
+
+namespace ui::external_app::ext_scanner {
+
+static_assert(FLOOR_SEGMENT_BINS % 4 == 0, "Segments must be whole words");
+static_assert(SPECTRUM_BINS % 32 == 0, "Bitmap must be whole words");
+
+namespace {
+
+constexpr uint32_t HIGH_BITS = 0x80808080;
+constexpr uint32_t LOW_BITS = 0x7F7F7F7F;
+constexpr uint32_t EVEN_BYTES = 0x00FF00FF;
+
+// Gather the high bit of each byte into 4 bits, byte 0 (lowest bin) as bit 0
+inline uint32_t high_bits_to_nibble(uint32_t mask) {
+    return ((mask & HIGH_BITS) * 0x00204081) >> 28;
+}
+
+inline uint32_t load_word(const uint8_t* p) {
+    uint32_t word;
+    std::memcpy(&word, p, sizeof(word));  // Single LDR: p is word aligned
+    return word;
+}
+
+// High bit of each byte set where a >= b (unsigned), without carries between bytes
+inline uint32_t bytes_ge(uint32_t a, uint32_t b) {
+    uint32_t low_ge = (a | HIGH_BITS) - (b & LOW_BITS);
+    return ((a & ~b) | (~(a ^ b) & low_ge)) & HIGH_BITS;
+}
+
+}  // namespace
+
+void scan_bins(const uint8_t* db, const FloorSegments& thresholds, BinScan& scan) {
+    const uint8_t* words = static_cast<const uint8_t*>(__builtin_assume_aligned(db, 4));
+    uint32_t max_word = 0;
+
+    for (size_t segment = 0; segment < FLOOR_SEGMENTS; segment++) {
+        const uint32_t threshold_word = thresholds[segment] * 0x01010101u;
+        const size_t first_bin = segment * FLOOR_SEGMENT_BINS;
+        uint32_t sum = 0;
+        uint32_t above = 0;
+
+        for (size_t i = 0; i < FLOOR_SEGMENT_BINS; i += 4) {
+            const uint32_t power = load_word(words + first_bin + i);
+
+            uint32_t power_ge = bytes_ge(power, max_word);
+            uint32_t select = (power_ge >> 7) * 0xFF;
+            max_word = (power & select) | (max_word & ~select);
+
+            // Two 16-bit lanes, at most 2 * FLOOR_SEGMENT_BINS / 4 * 255 each
+            sum += (power & EVEN_BYTES) + ((power >> 8) & EVEN_BYTES);
+
+            uint32_t above_mask = ~bytes_ge(threshold_word, power);
+            above |= high_bits_to_nibble(above_mask) << i;
+        }
+
+        sum = (sum & 0xFFFF) + (sum >> 16);
+        scan.segment_mean[segment] = sum / FLOOR_SEGMENT_BINS;
+
+        // 32 / FLOOR_SEGMENT_BINS segments per bitmap word
+        const size_t shift = first_bin % 32;
+        if (shift == 0) scan.above[first_bin / 32] = 0;
+        scan.above[first_bin / 32] |= above << shift;
+    }
+
+    // Fold the 4 byte lanes
+    uint8_t max_power = 0;
+    for (size_t lane = 0; lane < 4; lane++) {
+        uint8_t power = max_word >> (lane * 8);
+        if (power > max_power) max_power = power;
+    }
+    scan.max_power = max_power;
+}
+
+void scan_bins_reference(const uint8_t* db, const FloorSegments& thresholds, BinScan& scan) {
+    scan.max_power = 0;
+    scan.above.fill(0);
+
+    for (size_t segment = 0; segment < FLOOR_SEGMENTS; segment++) {
+        uint32_t sum = 0;
+        for (size_t bin = segment * FLOOR_SEGMENT_BINS; bin < (segment + 1) * FLOOR_SEGMENT_BINS; bin++) {
+            uint8_t power = db[bin];
+            sum += power;
+            if (power > scan.max_power) scan.max_power = power;
+            if (power > thresholds[segment]) scan.above[bin / 32] |= 1u << (bin % 32);
+        }
+        scan.segment_mean[segment] = sum / FLOOR_SEGMENT_BINS;
+    }
+}
+
+namespace {
+
+// Lowest set bin of bitmap (inverted if invert) at or after from.
+// The trailing zero count of the word is the index of its lowest set bit.
+size_t next_bin(const BinScan& scan, size_t from, uint32_t invert) {
+    if (from >= SPECTRUM_BINS) return SPECTRUM_BINS;
+
+    size_t word_index = from / 32;
+    uint32_t word = (scan.above[word_index] ^ invert) & (0xFFFFFFFFu << (from % 32));
+
+    while (word == 0) {
+        if (++word_index == BITMAP_WORDS) return SPECTRUM_BINS;
+        word = scan.above[word_index] ^ invert;
+    }
+    return word_index * 32 + __builtin_ctz(word);
+}
+
+}  // namespace
+
+size_t next_above_bin(const BinScan& scan, size_t from) {
+    return next_bin(scan, from, 0);
+}
+
+size_t next_below_bin(const BinScan& scan, size_t from) {
+    return next_bin(scan, from, 0xFFFFFFFF);
+}
+
+} // namespace ui::external_app::ext_scanner
@@ -0,0 +1,37 @@
+#ifndef __EXT_SCANNER_BIN_KERNEL_H__
+#define __EXT_SCANNER_BIN_KERNEL_H__
+
+#include "scanner_detector.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Branch-free first pass over a frame, 4 bins per 32-bit word, in portable SWAR
+// arithmetic: the Cortex-M0 application core has no SIMD instructions, and host builds
+// run the same code.
+
+namespace ui::external_app::ext_scanner {
+
+constexpr size_t BITMAP_WORDS = SPECTRUM_BINS / 32;
+
+struct BinScan {
+    uint8_t max_power;
+    FloorSegments segment_mean;
+    // Bit (bin % 32) of word (bin / 32) is set if the bin is above its segment threshold
+    std::array<uint32_t, BITMAP_WORDS> above;
+};
+
+// db must be 4-byte aligned (ChannelSpectrum::db and SweepRecordingFrame::db are).
+// A bin is above if db[bin] > thresholds[bin / FLOOR_SEGMENT_BINS].
+void scan_bins(const uint8_t* db, const FloorSegments& thresholds, BinScan& scan);
+
+// One byte at a time, for checking scan_bins() and measuring its gain in the replay tool
+void scan_bins_reference(const uint8_t* db, const FloorSegments& thresholds, BinScan& scan);
+
+// First set / clear bin at or after from, SPECTRUM_BINS if none
+size_t next_above_bin(const BinScan& scan, size_t from);
+size_t next_below_bin(const BinScan& scan, size_t from);
+
+} // namespace ui::external_app::ext_scanner
+
+#endif
@@ -0,0 +1,164 @@
+#include "scanner_detector.hpp"
+#include "scanner_bin_kernel.hpp"
+#include "scanner_dome.hpp"
+#include <algorithm>
+
+namespace ui::external_app::ext_scanner {
+
+void SpectrumDetector::reset() {
+    window_.length = 0;
+    window_.run_open = false;
+    window_.run_overflow = false;
+}
+
+void SpectrumDetector::add_detection(const Detection& detection) {
+    if (result_.detection_count < MAX_DETECTIONS_PER_FRAME) {
+        result_.detections[result_.detection_count++] = detection;
+    } else {
+        result_.overflow_count++;
+    }
+}
+
+const SpectrumDetector::FrameResult& SpectrumDetector::process_frame(Frequency chunk_center, const uint8_t* db, bool in_sweep_order, const FloorSegments* floor) {
+    result_.detection_count = 0;
+    result_.overflow_count = 0;
+
+    // Per-segment thresholds: margin above the learned noise floor, or the fixed dBm threshold
+    FloorSegments thresholds;
+    if (floor && config_.floor_margin_db > 0) {
+        const int32_t margin_raw = (config_.floor_margin_db * RAW_MAX) / (MAX_SIGNAL_DBM - NOISE_FLOOR_DBM);
+        for (size_t segment = 0; segment < FLOOR_SEGMENTS; segment++) {
+            int32_t threshold = (*floor)[segment] + margin_raw;
+            thresholds[segment] = threshold < RAW_MAX ? threshold : RAW_MAX;
+        }
+    } else {
+        thresholds.fill(dbm_to_raw(config_.squelch_threshold));
+    }
+
+    // Max power, segment means and the above-threshold bitmap in one branch-free pass
+    BinScan scan;
+    scan_bins(db, thresholds, scan);
+    result_.max_power = scan.max_power;
+    result_.segment_mean = scan.segment_mean;
+
+    // Only the bins inside the overlap trim are used for signals
+    const size_t overlap = std::min<size_t>(config_.overlap_bins, MAX_OVERLAP_BINS);
+    const size_t first_bin = overlap;
+    const size_t end_bin = SPECTRUM_BINS - overlap;
+    const Frequency kept_start = chunk_center - (SPECTRUM_SLICE_WIDTH / 2) + (Frequency)first_bin * BIN_WIDTH;
+
+    if (in_sweep_order) {
+        stitch_frame(db, scan, first_bin, end_bin, kept_start);
+    } else {
+        extract_runs(db, scan, first_bin, end_bin, kept_start);
+    }
+
+    return result_;
+}
+
+void SpectrumDetector::stitch_frame(const uint8_t* db, const BinScan& scan, size_t first_bin, size_t end_bin, Frequency kept_start) {
+    // A gap (next range, sweep wrap) ends whatever was open at the end of the window
+    if (window_.length == 0 || kept_start != window_.start + (Frequency)window_.length * BIN_WIDTH) {
+        close_open_run();
+        window_.length = 0;
+        window_.start = kept_start;
+    }
+
+    // Signal runs (consecutive bins above threshold) straight from the bitmap
+    size_t signal_start_bin = next_above_bin(scan, first_bin);
+    if (signal_start_bin != first_bin) {
+        close_open_run();
+    }
+
+    const size_t kept_bins = end_bin - first_bin;
+    make_room(kept_bins);
+    const size_t offset = window_.length;  // Window position of first_bin
+    std::copy(db + first_bin, db + end_bin, window_.bins.begin() + offset);
+    window_.length += kept_bins;
+
+    while (signal_start_bin < end_bin) {
+        const size_t signal_end_bin = std::min(next_below_bin(scan, signal_start_bin + 1), end_bin);
+
+        // A run at the first kept bin continues the one open at the end of the previous chunk
+        const bool continued = signal_start_bin == first_bin && window_.run_open;
+        const size_t run_start = continued ? window_.run_start : offset + signal_start_bin - first_bin;
+
+        if (signal_end_bin == end_bin) {
+            // Reaches the end of the kept bins - may continue in the next chunk
+            window_.run_open = true;
+            window_.run_overflow = continued && window_.run_overflow;
+            window_.run_start = run_start;
+            break;
+        }
+
+        if (!(continued && window_.run_overflow)) {
+            add_run(window_.bins.data(), window_.length, window_.start, run_start, offset + signal_end_bin - first_bin - 1);
+        }
+        window_.run_open = false;
+        window_.run_overflow = false;
+
+        signal_start_bin = next_above_bin(scan, signal_end_bin + 1);
+    }
+}
+
+void SpectrumDetector::extract_runs(const uint8_t* db, const BinScan& scan, size_t first_bin, size_t end_bin, Frequency bins_start) {
+    // Runs cut by the kept edges are measured as seen
+    size_t signal_start_bin = next_above_bin(scan, first_bin);
+    while (signal_start_bin < end_bin) {
+        const size_t signal_end_bin = std::min(next_below_bin(scan, signal_start_bin + 1), end_bin);
+        add_run(db + first_bin, end_bin - first_bin, bins_start, signal_start_bin - first_bin, signal_end_bin - first_bin - 1);
+        signal_start_bin = next_above_bin(scan, signal_end_bin + 1);
+    }
+}
+
+void SpectrumDetector::close_open_run() {
+    if (window_.run_open && !window_.run_overflow) {
+        add_run(window_.bins.data(), window_.length, window_.start, window_.run_start, window_.length - 1);
+    }
+    window_.run_open = false;
+    window_.run_overflow = false;
+}
+
+void SpectrumDetector::make_room(size_t bins) {
+    if (window_.length + bins <= WINDOW_BINS) return;
+
+    // Only an open run and the margin before it are still needed; drop the run too
+    // if it has grown too wide to keep
+    size_t keep = 0;
+    if (window_.run_open && !window_.run_overflow) {
+        keep = window_.length - window_.run_start + std::min(window_.run_start, DOME_MARGIN_BINS);
+        if (keep + bins > WINDOW_BINS) {
+            window_.run_overflow = true;
+            keep = 0;
+        }
+    }
+
+    const size_t drop = window_.length - keep;
+    std::copy(window_.bins.begin() + drop, window_.bins.begin() + window_.length, window_.bins.begin());
+    window_.start += (Frequency)drop * BIN_WIDTH;
+    window_.length = keep;
+    window_.run_start = window_.run_start > drop ? window_.run_start - drop : 0;
+}
+
+void SpectrumDetector::add_run(const uint8_t* bins, size_t bin_count, Frequency bins_start, size_t start_bin, size_t end_bin) {
+    const Frequency signal_width = (Frequency)(end_bin - start_bin + 1) * BIN_WIDTH;
+    if (signal_width < (Frequency)config_.min_signal_width_mhz * 1000000 ||
+        signal_width > (Frequency)config_.max_signal_width_mhz * 1000000) {
+        return;
+    }
+
+    size_t peak_bin = start_bin;
+    for (size_t bin = start_bin + 1; bin <= end_bin; bin++) {
+        if (bins[bin] > bins[peak_bin]) peak_bin = bin;
+    }
+
+    const DomeMatch dome = match_dome_template(bins, bin_count, start_bin, end_bin);
+    add_detection({bins_start + (Frequency)peak_bin * BIN_WIDTH,
+                   bins_start + (Frequency)(start_bin + end_bin) * BIN_WIDTH / 2,
+                   signal_width,
+                   raw_to_dbm(bins[peak_bin]),
+                   dome.confidence >= config_.min_dome_confidence,
+                   dome.confidence});
+}
+
+} // namespace ui::external_app::ext_scanner
@@ -0,0 +1,137 @@
+#ifndef __EXT_SCANNER_DETECTOR_H__
+#define __EXT_SCANNER_DETECTOR_H__
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Hardware-independent detection core.
+// Has no PortaPack dependencies so the same code runs on the device and
+// in the host replay tool (host/scanner_replay.cpp).
+
+namespace ui::external_app::ext_scanner {
+
+struct BinScan;
+
+using Frequency = int64_t;  // Same representation as rf::Frequency
+
+// Spectrum capture settings
+constexpr uint32_t SPECTRUM_SLICE_WIDTH = 20000000;  // 20 MHz chunks
+constexpr size_t SPECTRUM_BINS = 256;                // FFT bins per chunk
+constexpr Frequency BIN_WIDTH = SPECTRUM_SLICE_WIDTH / SPECTRUM_BINS;  // ~78 kHz per bin
+
+// Linear mapping of spectrum.db[] values: NOISE_FLOOR_DBM → RAW_MIN, MAX_SIGNAL_DBM → RAW_MAX
+constexpr int32_t NOISE_FLOOR_DBM = -120;  // Typical RF receiver noise floor
+constexpr int32_t MAX_SIGNAL_DBM = 0;      // Maximum signal power (1 mW)
+constexpr uint8_t RAW_MIN = 0;             // spectrum.db[] minimum value
+constexpr uint8_t RAW_MAX = 255;           // spectrum.db[] maximum value
+
+constexpr int32_t dbm_to_raw(int32_t dbm) {
+    int32_t raw = ((dbm - NOISE_FLOOR_DBM) * RAW_MAX) / (MAX_SIGNAL_DBM - NOISE_FLOOR_DBM);
+    if (raw < RAW_MIN) raw = RAW_MIN;
+    if (raw > RAW_MAX) raw = RAW_MAX;
+    return raw;
+}
+
+constexpr int32_t raw_to_dbm(uint8_t raw) {
+    return NOISE_FLOOR_DBM + (raw * (MAX_SIGNAL_DBM - NOISE_FLOOR_DBM) / RAW_MAX);
+}
+
+// Chunk overlap: the filter roll-off at both edges of a chunk is trimmed. Each chunk keeps
+// bins [overlap_bins, SPECTRUM_BINS - overlap_bins) and the sweep steps by exactly what it
+// keeps, so the kept bins of consecutive chunks join into one continuous spectrum.
+constexpr uint32_t MAX_OVERLAP_BINS = 32;     // 2.5 MHz per edge
+constexpr uint32_t DEFAULT_OVERLAP_BINS = 8;  // 625 kHz per edge, 18.75 MHz step
+
+constexpr Frequency chunk_step(uint32_t overlap_bins) {
+    return (SPECTRUM_BINS - 2 * overlap_bins) * BIN_WIDTH;
+}
+
+// Noise floor resolution: one estimate per FLOOR_SEGMENT_BINS bins (1.25 MHz)
+constexpr size_t FLOOR_SEGMENT_BINS = 16;
+constexpr size_t FLOOR_SEGMENTS = SPECTRUM_BINS / FLOOR_SEGMENT_BINS;
+using FloorSegments = std::array<uint8_t, FLOOR_SEGMENTS>;  // Raw units
+
+struct DetectorConfig {
+    int32_t squelch_threshold = -100;  // dBm, used when floor_margin_db is 0 or the chunk has no floor yet
+    int32_t floor_margin_db = 0;       // Signal threshold above the learned noise floor, 0 = off
+    uint32_t min_signal_width_mhz = 4;
+    uint32_t max_signal_width_mhz = 8;  // Up to SpectrumDetector::MAX_SIGNAL_WIDTH_MHZ
+    uint32_t overlap_bins = DEFAULT_OVERLAP_BINS;  // Must match the sweep, up to MAX_OVERLAP_BINS
+    uint32_t min_dome_confidence = 80;             // Dome template match (0-100) to count as FM video
+};
+
+// Signal run whose width matched the configured BW Min/BW Max window
+struct Detection {
+    Frequency freq;           // Frequency of the peak bin
+    Frequency center;         // Middle of the run, the frequency it is credited to
+    Frequency width;          // Measured on the stitched spectrum, so exact across chunk edges
+    int32_t rssi;             // Peak power, dBm
+    bool has_video_dome;      // FM video dome shape (FPV drone): dome_confidence >= min_dome_confidence
+    uint8_t dome_confidence;  // 0-100 from match_dome_template(), for ranking detections
+};
+
+class SpectrumDetector {
+public:
+    // A 256-bin frame can't hold more than ~18 runs of the narrowest allowed width (1 MHz),
+    // plus a run closed at the end of the previous range
+    static constexpr size_t MAX_DETECTIONS_PER_FRAME = 20;
+
+    // Stitched spectrum kept for measuring runs (80 MHz). A run is always measurable up to
+    // WINDOW_BINS - SPECTRUM_BINS - DOME_MARGIN_BINS bins (55 MHz); anything wider is never reported.
+    static constexpr size_t WINDOW_BINS = 1024;
+    // Bins kept before an open run for the dome templates, which reach past the run edges
+    static constexpr size_t DOME_MARGIN_BINS = 64;
+    // Widest BW Max that can ever match
+    static constexpr uint32_t MAX_SIGNAL_WIDTH_MHZ = (WINDOW_BINS - SPECTRUM_BINS - DOME_MARGIN_BINS) * BIN_WIDTH / 1000000;
+
+    struct FrameResult {
+        uint8_t max_power = RAW_MIN;  // Raw max power in the chunk
+        size_t detection_count = 0;
+        size_t overflow_count = 0;    // Detections that didn't fit into the array
+        FloorSegments segment_mean{}; // Mean raw power per floor segment, input to NoiseFloorModel
+        std::array<Detection, MAX_DETECTIONS_PER_FRAME> detections{};
+    };
+
+    void set_config(const DetectorConfig& config) { config_ = config; }
+    const DetectorConfig& config() const { return config_; }
+
+    // Forget the stitched spectrum, e.g. when the sweep restarts
+    void reset();
+
+    // Analyze one frame of SPECTRUM_BINS raw power values captured at chunk_center.
+    // Frames in sweep order are stitched: a run reaching the end of the kept bins is only
+    // reported once it ends in a following chunk, or when the next frame isn't contiguous
+    // (new range, sweep wrap). Frames out of sweep order (revisits) are analyzed on their
+    // own and leave the stitched spectrum untouched.
+    // floor is the chunk's learned noise floor, nullptr to use the fixed threshold.
+    // The result stays valid until the next call.
+    const FrameResult& process_frame(Frequency chunk_center, const uint8_t* db,
+                                     bool in_sweep_order = true, const FloorSegments* floor = nullptr);
+
+private:
+    DetectorConfig config_{};
+    FrameResult result_{};
+
+    // Kept bins of the last chunks in sweep order, compacted only when full
+    struct StitchWindow {
+        Frequency start = 0;      // Frequency of bins[0]
+        size_t length = 0;        // Valid bins
+        bool run_open = false;    // A run reaches the end of the window
+        bool run_overflow = false;  // The open run no longer fits, it won't be reported
+        size_t run_start = 0;
+        alignas(4) std::array<uint8_t, WINDOW_BINS> bins{};
+    };
+    StitchWindow window_{};
+
+    void stitch_frame(const uint8_t* db, const BinScan& scan, size_t first_bin, size_t end_bin, Frequency kept_start);
+    void extract_runs(const uint8_t* db, const BinScan& scan, size_t first_bin, size_t end_bin, Frequency bins_start);
+    void close_open_run();
+    void make_room(size_t bins);
+    void add_run(const uint8_t* bins, size_t bin_count, Frequency bins_start, size_t start_bin, size_t end_bin);
+    void add_detection(const Detection& detection);
+};
+
+} // namespace ui::external_app::ext_scanner
+
+#endif
@@ -0,0 +1,154 @@
+#include "scanner_dome.hpp"
+#include <algorithm>
+#include <array>
+
+namespace ui::external_app::ext_scanner {
+
+namespace {
+
+constexpr size_t template_bins(uint32_t width_mhz) {
+    return (width_mhz * 1000000 + BIN_WIDTH / 2) / BIN_WIDTH;
+}
+
+constexpr size_t half_template_bins(uint32_t width_mhz) {
+    return (template_bins(width_mhz) + 1) / 2;
+}
+
+constexpr size_t total_half_template_bins() {
+    size_t total = 0;
+    for (uint32_t width = DOME_TEMPLATE_MIN_MHZ; width <= DOME_TEMPLATE_MAX_MHZ; width++) {
+        total += half_template_bins(width);
+    }
+    return total;
+}
+
+struct DomeTemplates {
+    std::array<uint16_t, DOME_TEMPLATE_MAX_MHZ + 1> offset{};  // Into half, by width in MHz
+    std::array<uint32_t, DOME_TEMPLATE_MAX_MHZ + 1> sum{};     // Of the whole template
+    std::array<uint32_t, DOME_TEMPLATE_MAX_MHZ + 1> sum_squares{};
+    std::array<uint8_t, total_half_template_bins()> half{};    // Rising half of each template
+};
+
+// Template bin i of n: 255 * (1 - t^2) with t = (2i + 1 - n) / n, the bin center in (-1, 1)
+constexpr DomeTemplates make_dome_templates() {
+    DomeTemplates templates{};
+    size_t offset = 0;
+    for (uint32_t width = DOME_TEMPLATE_MIN_MHZ; width <= DOME_TEMPLATE_MAX_MHZ; width++) {
+        const int32_t n = template_bins(width);
+        templates.offset[width] = offset;
+        for (int32_t i = 0; i < n; i++) {
+            const int32_t t = 2 * i + 1 - n;
+            const uint32_t y = 255 * (n * n - t * t) / (n * n);
+            if (i < (n + 1) / 2) templates.half[offset + i] = y;
+            templates.sum[width] += y;
+            templates.sum_squares[width] += y * y;
+        }
+        offset += half_template_bins(width);
+    }
+    return templates;
+}
+
+constexpr DomeTemplates DOME_TEMPLATES = make_dome_templates();
+
+static_assert(sizeof(DOME_TEMPLATES.half) < 1400, "Dome templates take app memory");
+static_assert(template_bins(DOME_TEMPLATE_MAX_MHZ) <= SPECTRUM_BINS, "Template wider than a chunk");
+
+// Squared Pearson correlation of the template placed at bins[first] with bins[begin, end),
+// the part of it inside the available bins, 0-100. sum_x and sum_xx are over bins[begin, end).
+uint8_t correlate(const uint8_t* bins, int32_t first, int32_t begin, int32_t end, uint32_t width_mhz,
+                  uint32_t sum_x, uint32_t sum_xx) {
+    const int32_t n = template_bins(width_mhz);
+    const int32_t half_n = (n + 1) / 2;
+    const uint8_t* half = &DOME_TEMPLATES.half[DOME_TEMPLATES.offset[width_mhz]];
+    const int32_t count = end - begin;
+
+    // Rising and falling halves separately, the template is stored once.
+    // first may be negative, so index bins with the signed sum rather than offset the pointer.
+    uint32_t sum_xy = 0;
+    for (int32_t i = begin - first; i < std::min(end - first, half_n); i++) {
+        sum_xy += bins[first + i] * half[i];
+    }
+    for (int32_t i = std::max(begin - first, half_n); i < end - first; i++) {
+        sum_xy += bins[first + i] * half[n - 1 - i];
+    }
+
+    uint32_t sum_y = DOME_TEMPLATES.sum[width_mhz];
+    uint32_t sum_yy = DOME_TEMPLATES.sum_squares[width_mhz];
+    if (count != n) {
+        sum_y = sum_yy = 0;
+        for (int32_t i = begin - first; i < end - first; i++) {
+            const uint32_t y = half[i < half_n ? i : n - 1 - i];
+            sum_y += y;
+            sum_yy += y * y;
+        }
+    }
+
+    // count * sum <= 256 * 256 * 255 * 255 needs 64 bits
+    const int64_t cov = (int64_t)count * sum_xy - (int64_t)sum_x * sum_y;
+    if (cov <= 0) return 0;
+    uint64_t var_x = (uint64_t)count * sum_xx - (uint64_t)sum_x * sum_x;
+    uint64_t var_y = (uint64_t)count * sum_yy - (uint64_t)sum_y * sum_y;
+    uint64_t c = cov;
+
+    // Same shift on all three keeps the ratio; 26 bits each leaves room for c * c * 100
+    while ((c | var_x | var_y) >= (1ull << 26)) {
+        c >>= 1;
+        var_x >>= 1;
+        var_y >>= 1;
+    }
+    if (var_x == 0 || var_y == 0) return 0;
+
+    const uint64_t r2 = (c * c * 100) / (var_x * var_y);
+    return r2 < 100 ? r2 : 100;
+}
+
+}  // namespace
+
+DomeMatch match_dome_template(const uint8_t* bins, size_t bin_count, size_t start_bin, size_t end_bin) {
+    DomeMatch best;
+    if (end_bin <= start_bin || end_bin >= bin_count) return best;
+
+    // Run width in MHz is bins * 5 / 64 (BIN_WIDTH is 78.125 kHz)
+    static_assert(BIN_WIDTH * 64 == 5 * 1000000, "Width conversion assumes 78.125 kHz bins");
+    const uint32_t run_bins = end_bin - start_bin + 1;
+    uint32_t min_width = run_bins * 5 / 64;
+    uint32_t max_width = (run_bins * 15 + 127) / 128;
+    if (min_width < DOME_TEMPLATE_MIN_MHZ) min_width = DOME_TEMPLATE_MIN_MHZ;
+    if (min_width > DOME_TEMPLATE_MAX_MHZ) min_width = DOME_TEMPLATE_MAX_MHZ;
+    if (max_width > DOME_TEMPLATE_MAX_MHZ) max_width = DOME_TEMPLATE_MAX_MHZ;
+
+    // Twice the run center, so odd and even template widths center alike
+    const int32_t center2 = start_bin + end_bin + 1;
+
+    // Each wider template covers the previous one, so the sums over the bins only grow
+    int32_t low = center2 / 2;
+    int32_t high = low;
+    uint32_t sum_x = 0;
+    uint32_t sum_xx = 0;
+
+    for (uint32_t width = min_width; width <= max_width; width++) {
+        const int32_t n = template_bins(width);
+        const int32_t first = (center2 - n) / 2;
+        const int32_t begin = std::max(first, (int32_t)0);
+        const int32_t end = std::min(first + n, (int32_t)bin_count);
+        if (end - begin < n / 2) continue;  // Mostly outside the available bins
+
+        for (; low > begin; low--) {
+            sum_x += bins[low - 1];
+            sum_xx += bins[low - 1] * bins[low - 1];
+        }
+        for (; high < end; high++) {
+            sum_x += bins[high];
+            sum_xx += bins[high] * bins[high];
+        }
+
+        const uint8_t confidence = correlate(bins, first, begin, end, width, sum_x, sum_xx);
+        if (confidence > best.confidence) {
+            best.confidence = confidence;
+            best.width_mhz = width;
+        }
+    }
+    return best;
+}
+
+} // namespace ui::external_app::ext_scanner
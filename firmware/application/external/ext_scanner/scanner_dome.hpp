@@ -0,0 +1,30 @@
+#ifndef __EXT_SCANNER_DOME_H__
+#define __EXT_SCANNER_DOME_H__
+
+#include "scanner_detector.hpp"
+#include <cstddef>
+#include <cstdint>
+
+// FM video dome classifier: correlates the whole run against fixed-point dome templates.
+// An FM carrier modulated by video has a roughly Gaussian spectrum (Woodward), which is a
+// parabola in the dB values of db[]. One template per whole MHz of width is generated at
+// compile time (half of each is stored, they are symmetric). Integer arithmetic only.
+
+namespace ui::external_app::ext_scanner {
+
+constexpr uint32_t DOME_TEMPLATE_MIN_MHZ = 1;
+constexpr uint32_t DOME_TEMPLATE_MAX_MHZ = 20;  // Wider runs are matched against the 20 MHz template
+
+struct DomeMatch {
+    uint8_t confidence = 0;  // Squared correlation with the best template, 0-100 (0 for inverted shapes)
+    uint8_t width_mhz = 0;   // Width of the best template, i.e. the estimated full dome width
+};
+
+// Classify run [start_bin, end_bin] of bins[0, bin_count). The dome usually extends below
+// the threshold, so templates from the run width up to 1.5x it are centered on the run and
+// may reach past it into the surrounding bins; they are clipped at the ends of bins.
+DomeMatch match_dome_template(const uint8_t* bins, size_t bin_count, size_t start_bin, size_t end_bin);
+
+} // namespace ui::external_app::ext_scanner
+
+#endif
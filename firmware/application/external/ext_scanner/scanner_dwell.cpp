@@ -0,0 +1,67 @@
+#include "scanner_dwell.hpp"
+
+namespace ui::external_app::ext_scanner {
+
+void DwellAccumulator::configure(uint32_t frames, DwellMode mode) {
+    if (frames < 1) frames = 1;
+    if (frames > MAX_FRAMES) frames = MAX_FRAMES;
+
+    frames_ = frames;
+    mode_ = mode;
+    mean_reciprocal_ = (0x10000 + frames_ - 1) / frames_;
+    count_ = 0;
+}
+
+bool DwellAccumulator::add(const uint8_t* db) {
+    if (frames_ == 1) {
+        result_ = db;
+        return true;
+    }
+
+    if (count_ == 0) {
+        if (mode_ == DwellMode::Mean) {
+            for (size_t bin = 0; bin < SPECTRUM_BINS; bin++) {
+                sum_[bin] = db[bin];
+            }
+        } else {
+            for (size_t bin = 0; bin < SPECTRUM_BINS; bin++) {
+                output_[bin] = db[bin];
+            }
+        }
+    } else {
+        switch (mode_) {
+            case DwellMode::MaxHold:
+                for (size_t bin = 0; bin < SPECTRUM_BINS; bin++) {
+                    if (db[bin] > output_[bin]) output_[bin] = db[bin];
+                }
+                break;
+
+            case DwellMode::Mean:
+                for (size_t bin = 0; bin < SPECTRUM_BINS; bin++) {
+                    sum_[bin] += db[bin];
+                }
+                break;
+
+            case DwellMode::Min:
+                for (size_t bin = 0; bin < SPECTRUM_BINS; bin++) {
+                    if (db[bin] < output_[bin]) output_[bin] = db[bin];
+                }
+                break;
+        }
+    }
+
+    if (++count_ < frames_) return false;
+
+    if (mode_ == DwellMode::Mean) {
+        // Multiply by the reciprocal instead of dividing: no hardware divider on the M0
+        for (size_t bin = 0; bin < SPECTRUM_BINS; bin++) {
+            output_[bin] = (sum_[bin] * mean_reciprocal_) >> 16;
+        }
+    }
+
+    count_ = 0;
+    result_ = output_.data();
+    return true;
+}
+
+} // namespace ui::external_app::ext_scanner
@@ -0,0 +1,50 @@
+#ifndef __EXT_SCANNER_DWELL_H__
+#define __EXT_SCANNER_DWELL_H__
+
+#include "scanner_detector.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace ui::external_app::ext_scanner {
+
+enum class DwellMode : uint8_t {
+    MaxHold = 0,
+    Mean = 1,
+    Min = 2,
+};
+
+// Integrates N consecutive frames of one chunk into a single frame for the detector.
+// Frames are folded in as they arrive, so memory is fixed (768 bytes) whatever N is.
+class DwellAccumulator {
+public:
+    static constexpr uint32_t MAX_FRAMES = 8;  // Mean sums must fit in uint16_t
+
+    // Also drops a partially integrated chunk
+    void configure(uint32_t frames, DwellMode mode);
+    uint32_t frames() const { return frames_; }
+    DwellMode mode() const { return mode_; }
+
+    // Drop a partially integrated chunk, e.g. after a retune
+    void reset() { count_ = 0; }
+
+    // Fold in one frame. True when frames() frames are in and frame() holds the result.
+    bool add(const uint8_t* db);
+
+    // Integrated frame, 4-byte aligned. With a single frame dwell this is the last db passed to add().
+    const uint8_t* frame() const { return result_; }
+
+private:
+    uint32_t frames_ = 1;
+    DwellMode mode_ = DwellMode::MaxHold;
+    uint32_t count_ = 0;
+    uint32_t mean_reciprocal_ = 0x10000;  // ceil(65536 / frames_), exact for sums up to MAX_FRAMES * 255
+    const uint8_t* result_ = nullptr;
+
+    alignas(4) std::array<uint8_t, SPECTRUM_BINS> output_{};
+    std::array<uint16_t, SPECTRUM_BINS> sum_{};
+};
+
+} // namespace ui::external_app::ext_scanner
+
+#endif
@@ -0,0 +1,165 @@
+#include "scanner_emitters.hpp"
+#include <cstdlib>
+
+namespace ui::external_app::ext_scanner {
+
+void EmitterTracker::clear() {
+    head_.fill(NONE);
+    for (size_t i = 0; i < MAX_EMITTERS; i++) {
+        next_[i] = i + 1 < MAX_EMITTERS ? i + 1 : NONE;
+    }
+    free_ = 0;
+    cycle_ = 0;
+    threat_count_ = 0;
+}
+
+uint8_t EmitterTracker::find(Frequency center, Frequency radius) const {
+    const int64_t bucket = center / BUCKET_WIDTH;
+    int64_t reach = radius / BUCKET_WIDTH + 1;
+    if (reach > (int64_t)HASH_SLOTS / 2) reach = HASH_SLOTS / 2;  // Every slot is probed by then
+    uint8_t best = NONE;
+    Frequency best_distance = radius + 1;
+
+    for (int64_t b = bucket - reach; b <= bucket + reach; b++) {
+        for (uint8_t i = head_[slot_of(b)]; i != NONE; i = next_[i]) {
+            const Frequency distance = std::llabs(emitters_[i].center - center);
+            if (distance < best_distance) {
+                best_distance = distance;
+                best = i;
+            }
+        }
+    }
+    return best;
+}
+
+void EmitterTracker::link(uint8_t index) {
+    const size_t slot = slot_of(emitters_[index].center / BUCKET_WIDTH);
+    next_[index] = head_[slot];
+    head_[slot] = index;
+}
+
+void EmitterTracker::unlink(uint8_t index) {
+    uint8_t* link = &head_[slot_of(emitters_[index].center / BUCKET_WIDTH)];
+    while (*link != index) {
+        link = &next_[*link];
+    }
+    *link = next_[index];
+}
+
+uint8_t EmitterTracker::pick_victim() const {
+    // Longest idle, threats only if everything is a threat, weakest on a tie
+    uint8_t victim = NONE;
+    for (uint8_t i = 0; i < MAX_EMITTERS; i++) {
+        if (victim == NONE) {
+            victim = i;
+            continue;
+        }
+        const Emitter& e = emitters_[i];
+        const Emitter& v = emitters_[victim];
+        if (e.threat != v.threat) {
+            if (!e.threat) victim = i;
+        } else if (e.last_seen_cycle != v.last_seen_cycle) {
+            if (e.last_seen_cycle < v.last_seen_cycle) victim = i;
+        } else if (e.peak_rssi < v.peak_rssi) {
+            victim = i;
+        }
+    }
+    return victim;
+}
+
+uint8_t EmitterTracker::allocate() {
+    if (free_ == NONE) {
+        // Full: every index is in use, so any of them can be recycled
+        const uint8_t victim = pick_victim();
+        unlink(victim);
+        return victim;
+    }
+
+    const uint8_t index = free_;
+    free_ = next_[index];
+    return index;
+}
+
+EmitterTracker::Update EmitterTracker::update(const Detection& detection, uint32_t now_ms) {
+    const Frequency radius = detection.width / 2 > BUCKET_WIDTH ? detection.width / 2 : BUCKET_WIDTH;
+    uint8_t index = find(detection.center, radius);
+
+    if (index == NONE) {
+        index = allocate();
+        emitters_[index] = {detection.center, detection.freq, detection.width, detection.rssi,
+                            now_ms, now_ms, cycle_, cycle_, 1, detection.dome_confidence,
+                            detection.has_video_dome};
+        link(index);
+
+        if (detection.has_video_dome) {
+            threat_count_++;
+            return Update::NewThreat;
+        }
+        return Update::NewEmitter;
+    }
+
+    Emitter& emitter = emitters_[index];
+    emitter.last_seen_ms = now_ms;
+    emitter.last_seen_cycle = cycle_;
+    emitter.hits++;
+    if (detection.rssi > emitter.peak_rssi) {
+        emitter.peak_rssi = detection.rssi;
+        emitter.peak_freq = detection.freq;
+    }
+    if (detection.width > emitter.width) emitter.width = detection.width;
+    if (detection.dome_confidence > emitter.dome_confidence) emitter.dome_confidence = detection.dome_confidence;
+
+    if (detection.has_video_dome && !emitter.threat) {
+        emitter.threat = true;
+        threat_count_++;
+        return Update::BecameThreat;
+    }
+    return Update::Known;
+}
+
+EmitterTracker::CycleReport EmitterTracker::end_cycle() {
+    CycleReport report;
+    report.cycle = cycle_;
+
+    for (size_t slot = 0; slot < HASH_SLOTS; slot++) {
+        uint8_t i = head_[slot];
+        while (i != NONE) {
+            const uint8_t next = next_[i];
+            const Emitter& emitter = emitters_[i];
+
+            if (emitter.last_seen_cycle == cycle_) {
+                report.active++;
+                if (emitter.first_seen_cycle == cycle_) report.new_count++;
+                if (!report.strongest || emitter.peak_rssi > report.strongest->peak_rssi) {
+                    report.strongest = &emitter;
+                }
+                if (!report.newest || emitter.first_seen_ms > report.newest->first_seen_ms) {
+                    report.newest = &emitter;
+                }
+            } else if (cycle_ - emitter.last_seen_cycle >= MAX_IDLE_CYCLES) {
+                unlink(i);
+                next_[i] = free_;
+                free_ = i;
+            }
+            i = next;
+        }
+    }
+
+    cycle_++;
+    return report;
+}
+
+const Emitter* EmitterTracker::strongest_threat() const {
+    const Emitter* strongest = nullptr;
+    for (size_t slot = 0; slot < HASH_SLOTS; slot++) {
+        for (uint8_t i = head_[slot]; i != NONE; i = next_[i]) {
+            const Emitter& emitter = emitters_[i];
+            if (emitter.threat && (!strongest || emitter.peak_rssi > strongest->peak_rssi)) {
+                strongest = &emitter;
+            }
+        }
+    }
+    return strongest;
+}
+
+} // namespace ui::external_app::ext_scanner
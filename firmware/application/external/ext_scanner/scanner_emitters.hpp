@@ -0,0 +1,89 @@
+#ifndef __EXT_SCANNER_EMITTERS_H__
+#define __EXT_SCANNER_EMITTERS_H__
+
+#include "scanner_detector.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace ui::external_app::ext_scanner {
+
+// One transmitter, merged from every detection whose run center is near the one it was
+// first seen with. The peak of an FM video spectrum wanders with the picture by a few MHz,
+// the run center barely moves, so only the center is used for matching.
+struct Emitter {
+    Frequency center;           // Run center of the first detection, the table key
+    Frequency peak_freq;        // Peak frequency of the strongest detection, reported only
+    Frequency width;            // Widest detection
+    int32_t peak_rssi;          // dBm
+    uint32_t first_seen_ms;
+    uint32_t last_seen_ms;
+    uint32_t first_seen_cycle;
+    uint32_t last_seen_cycle;
+    uint32_t hits;              // Detections merged
+    uint8_t dome_confidence;    // Best
+    bool threat;                // Seen as an FM video dome at least once
+};
+
+// Fixed-capacity table of emitters, so a transmitter seen on many frames, revisits and
+// cycles is one entry (and one threat). Entries are chained per BUCKET_WIDTH bucket of
+// their center; a detection merges into the nearest center within half its width (at least
+// BUCKET_WIDTH) and probes only the buckets that radius reaches, so lookup stays O(1)
+// however many candidates a busy band produces. No allocation after construction.
+class EmitterTracker {
+public:
+    static constexpr size_t MAX_EMITTERS = 32;
+    static constexpr Frequency BUCKET_WIDTH = 2000000;  // Also the smallest merge radius
+    static constexpr uint32_t MAX_IDLE_CYCLES = 3;      // Entries not seen for longer are dropped
+
+    enum class Update : uint8_t {
+        Known,       // Merged into an existing emitter
+        NewEmitter,    // First sighting
+        NewThreat,     // First sighting, with a dome
+        BecameThreat,  // First dome on a known emitter
+    };
+
+    struct CycleReport {
+        uint32_t cycle = 0;
+        size_t active = 0;                  // Emitters seen this cycle
+        size_t new_count = 0;               // Of which first seen this cycle
+        const Emitter* strongest = nullptr; // Highest peak RSSI among the active ones
+        const Emitter* newest = nullptr;    // Latest first sighting among the active ones
+    };
+
+    EmitterTracker() { clear(); }
+
+    void clear();
+
+    // Merge a detection; now_ms is any monotonic millisecond clock
+    Update update(const Detection& detection, uint32_t now_ms);
+
+    // Summarize the cycle that just ended, then drop emitters idle for MAX_IDLE_CYCLES.
+    // The pointers stay valid until the next update() or clear().
+    CycleReport end_cycle();
+
+    uint32_t threat_count() const { return threat_count_; }  // Distinct dome emitters since clear()
+    const Emitter* strongest_threat() const;                 // Among the current entries
+
+private:
+    static constexpr size_t HASH_SLOTS = 64;  // Power of two
+    static constexpr uint8_t NONE = 0xFF;
+
+    std::array<Emitter, MAX_EMITTERS> emitters_{};
+    std::array<uint8_t, MAX_EMITTERS> next_{};  // Next in the hash chain, or in the free list
+    std::array<uint8_t, HASH_SLOTS> head_{};
+    uint8_t free_ = NONE;
+    uint32_t cycle_ = 0;
+    uint32_t threat_count_ = 0;
+
+    static size_t slot_of(int64_t bucket) { return (size_t)bucket & (HASH_SLOTS - 1); }
+    uint8_t find(Frequency center, Frequency radius) const;
+    uint8_t allocate();
+    void link(uint8_t index);
+    void unlink(uint8_t index);
+    uint8_t pick_victim() const;
+};
+
+} // namespace ui::external_app::ext_scanner
+
+#endif
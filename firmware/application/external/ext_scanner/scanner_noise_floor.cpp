@@ -0,0 +1,57 @@
+#include "scanner_noise_floor.hpp"
+#include <algorithm>
+
+namespace ui::external_app::ext_scanner {
+
+const FloorSegments* NoiseFloorModel::shifted_floor(size_t chunk_id, int32_t shift_segments, uint32_t overlap_bins,
+                                                    FloorSegments& out) const {
+    const FloorSegments* learned = floor(chunk_id);
+    if (!learned || shift_segments == 0) return learned;
+
+    // Segments wholly inside the kept bins [overlap_bins, SPECTRUM_BINS - overlap_bins)
+    const int32_t first_kept = (overlap_bins + FLOOR_SEGMENT_BINS - 1) / FLOOR_SEGMENT_BINS;
+    const int32_t last_kept = (SPECTRUM_BINS - overlap_bins) / FLOOR_SEGMENT_BINS - 1;
+
+    for (int32_t segment = 0; segment < (int32_t)FLOOR_SEGMENTS; segment++) {
+        const int32_t source = std::clamp(segment + shift_segments, first_kept, last_kept);
+        out[segment] = (*learned)[source];
+    }
+    return &out;
+}
+
+void NoiseFloorModel::update(size_t chunk_id, const FloorSegments& segment_mean) {
+    if (chunk_id >= MAX_CHUNKS) return;
+
+    auto& floor = floor_[chunk_id];
+
+    if (!seeded_[chunk_id]) {
+        // Most segments of a chunk are noise, so the median is a safe ceiling for the seed
+        FloorSegments sorted = segment_mean;
+        std::nth_element(sorted.begin(), sorted.begin() + FLOOR_SEGMENTS / 2, sorted.end());
+        int32_t ceiling = sorted[FLOOR_SEGMENTS / 2] + RISE_LIMIT;
+
+        for (size_t segment = 0; segment < FLOOR_SEGMENTS; segment++) {
+            floor[segment] = std::min<int32_t>(segment_mean[segment], ceiling);
+        }
+        seeded_[chunk_id] = true;
+        frame_count_[chunk_id] = 0;
+        return;
+    }
+
+    const bool recover = ++frame_count_[chunk_id] >= RECOVERY_INTERVAL;
+    if (recover) frame_count_[chunk_id] = 0;
+
+    for (size_t segment = 0; segment < FLOOR_SEGMENTS; segment++) {
+        int32_t level = floor[segment];
+        int32_t sample = segment_mean[segment];
+
+        if (sample < level) {
+            level -= (level - sample < DOWN_STEP) ? level - sample : DOWN_STEP;
+        } else if (sample > level && (sample < level + RISE_LIMIT || recover)) {
+            level += UP_STEP;
+        }
+        floor[segment] = level;
+    }
+}
+
+} // namespace ui::external_app::ext_scanner
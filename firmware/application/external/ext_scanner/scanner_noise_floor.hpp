@@ -0,0 +1,55 @@
+#ifndef __EXT_SCANNER_NOISE_FLOOR_H__
+#define __EXT_SCANNER_NOISE_FLOOR_H__
+
+#include "scanner_detector.hpp"
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+
+namespace ui::external_app::ext_scanner {
+
+// Learned noise floor per chunk and FLOOR_SEGMENT_BINS segment, one uint8 each
+// (MAX_CHUNKS * FLOOR_SEGMENTS = 4 KB, plus a frame counter per chunk). Updated once per frame from the segment means
+// the detector accumulates anyway, with integer steps only:
+// - a chunk's first frame seeds each segment with its mean, capped at the median segment
+//   mean + RISE_LIMIT, so a signal present at startup doesn't become floor
+// - afterwards the estimate falls DOWN_STEP per frame below it and rises UP_STEP per frame
+//   above it, tracking roughly the UP_STEP / (UP_STEP + DOWN_STEP) quantile over time
+// - samples RISE_LIMIT or more above the floor are treated as signal and raise it only
+//   UP_STEP per RECOVERY_INTERVAL frames, so a low seed or a step up in the real floor is
+//   still caught up with, while a signal has to stay for minutes to become floor
+class NoiseFloorModel {
+public:
+    // Default band plan is 172 chunks at the default overlap, 215 at MAX_OVERLAP_BINS.
+    // Later chunks of longer range lists use the fixed threshold, the app says so at START.
+    static constexpr size_t MAX_CHUNKS = 256;
+    static constexpr uint8_t UP_STEP = 1;
+    static constexpr uint8_t DOWN_STEP = 2;
+    static constexpr uint8_t RISE_LIMIT = 8;   // Raw units, ~4 dB
+    static constexpr uint8_t RECOVERY_INTERVAL = 32;  // Frames of a chunk
+
+    void clear() { seeded_.reset(); }
+
+    // nullptr until the chunk has been seen, or if chunk_id is beyond MAX_CHUNKS
+    const FloorSegments* floor(size_t chunk_id) const {
+        return (chunk_id < MAX_CHUNKS && seeded_[chunk_id]) ? &floor_[chunk_id] : nullptr;
+    }
+
+    // Floor of chunk_id for a frame tuned shift_segments segments off the chunk center
+    // (a revisit). Segments the chunk never kept repeat its nearest kept one. Same nullptr
+    // cases as floor(); otherwise points at out, or the floor itself when not shifted.
+    const FloorSegments* shifted_floor(size_t chunk_id, int32_t shift_segments, uint32_t overlap_bins,
+                                       FloorSegments& out) const;
+
+    void update(size_t chunk_id, const FloorSegments& segment_mean);
+
+private:
+    std::array<FloorSegments, MAX_CHUNKS> floor_{};
+    std::bitset<MAX_CHUNKS> seeded_{};
+    std::array<uint8_t, MAX_CHUNKS> frame_count_{};  // Frames since the last recovery step
+};
+
+} // namespace ui::external_app::ext_scanner
+
+#endif
@@ -0,0 +1,80 @@
+#include "scanner_overview.hpp"
+#include <algorithm>
+
+namespace ui::external_app::ext_scanner {
+
+bool SpectrumOverview::configure(const std::vector<FrequencyRange>& ranges, uint32_t overlap_bins,
+                                 size_t columns, size_t rows) {
+    ranges_.clear();
+    cells_.clear();
+    overlap_bins_ = std::min(overlap_bins, MAX_OVERLAP_BINS);
+
+    const uint32_t kept_bins = SPECTRUM_BINS - 2 * overlap_bins_;
+    for (size_t i = 0; i < ranges.size(); i++) {
+        if (!ranges[i].enabled) continue;
+        ranges_.push_back({i, (uint32_t)(range_chunk_count(ranges[i], overlap_bins_) * kept_bins), 0});
+    }
+    if (ranges_.empty()) return false;
+
+    // Room for at least one completed row next to the one being filled
+    columns_ = std::min(columns, MAX_BYTES / (ranges_.size() * 2));
+    if (columns_ == 0) {
+        ranges_.clear();
+        return false;
+    }
+    rows_ = std::min(rows + 1, MAX_BYTES / (ranges_.size() * columns_));
+
+    for (auto& layout : ranges_) {
+        // bin * column_scale stays below columns << 16, no overflow for any range width
+        layout.column_scale = ((uint64_t)columns_ << 16) / layout.bins;
+    }
+
+    cells_.resize(ranges_.size() * rows_ * columns_);
+    clear();
+    return true;
+}
+
+void SpectrumOverview::clear() {
+    std::fill(cells_.begin(), cells_.end(), RAW_MIN);
+    current_row_ = 0;
+    completed_rows_ = 0;
+}
+
+void SpectrumOverview::add(size_t range_index, size_t chunk_index, const uint8_t* db) {
+    for (size_t slot = 0; slot < ranges_.size(); slot++) {
+        const auto& layout = ranges_[slot];
+        if (layout.range_index != range_index) continue;
+
+        const uint32_t kept_bins = SPECTRUM_BINS - 2 * overlap_bins_;
+        const uint32_t first_bin = chunk_index * kept_bins;  // In the whole range
+        uint8_t* cells = cell_row(slot, current_row_);
+
+        // The last chunk may run past the range end (ranges edited while scanning, too)
+        for (uint32_t i = 0; i < kept_bins && first_bin + i < layout.bins; i++) {
+            uint8_t& cell = cells[((first_bin + i) * layout.column_scale) >> 16];
+            const uint8_t power = db[overlap_bins_ + i];
+            if (power > cell) cell = power;
+        }
+        return;
+    }
+}
+
+void SpectrumOverview::next_row() {
+    if (cells_.empty()) return;
+
+    current_row_ = (current_row_ + 1) % rows_;
+    if (completed_rows_ < rows_ - 1) completed_rows_++;
+
+    for (size_t slot = 0; slot < ranges_.size(); slot++) {
+        std::fill_n(cell_row(slot, current_row_), columns_, RAW_MIN);
+    }
+}
+
+const uint8_t* SpectrumOverview::row(size_t range_slot, size_t age) const {
+    if (range_slot >= ranges_.size() || age >= completed_rows_) return nullptr;
+
+    const size_t row = (current_row_ + rows_ - 1 - age) % rows_;
+    return cells_.data() + (range_slot * rows_ + row) * columns_;
+}
+
+} // namespace ui::external_app::ext_scanner
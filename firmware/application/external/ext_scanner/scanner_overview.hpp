@@ -0,0 +1,61 @@
+#ifndef __EXT_SCANNER_OVERVIEW_H__
+#define __EXT_SCANNER_OVERVIEW_H__
+
+#include "scanner_detector.hpp"
+#include "scanner_sweep.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ui::external_app::ext_scanner {
+
+// Whole-range spectrum built from the kept bins of the linear sweep, for overview and
+// waterfall rendering without extra captures. Each enabled range is decimated to a fixed
+// number of columns (max-hold, so narrow signals survive), one row per scan cycle, kept
+// in a ring of rows per range. The whole buffer is bounded by MAX_BYTES.
+class SpectrumOverview {
+public:
+    static constexpr size_t MAX_BYTES = 4096;
+
+    // Lay out the enabled ranges as swept with overlap_bins. Columns and rows are reduced
+    // to fit MAX_BYTES. False (and empty) if not even 1 column per range fits.
+    bool configure(const std::vector<FrequencyRange>& ranges, uint32_t overlap_bins,
+                   size_t columns, size_t rows);
+    void clear();
+
+    // Fold a frame of the linear sweep into the current row
+    void add(size_t range_index, size_t chunk_index, const uint8_t* db);
+
+    // Current row becomes the newest completed row; call at the end of every cycle
+    void next_row();
+
+    size_t range_count() const { return ranges_.size(); }
+    size_t columns() const { return columns_; }
+    size_t completed_rows() const { return completed_rows_; }
+
+    // Completed row of the n-th configured range, age 0 is the last cycle. nullptr if not there yet.
+    const uint8_t* row(size_t range_slot, size_t age) const;
+
+private:
+    struct RangeLayout {
+        size_t range_index;     // In the range list the sweep walks
+        uint32_t bins;          // Kept bins over the whole range
+        uint32_t column_scale;  // Columns per bin, 16.16 fixed point
+    };
+
+    std::vector<RangeLayout> ranges_{};
+    std::vector<uint8_t> cells_{};  // [range][row][column]
+    uint32_t overlap_bins_ = 0;
+    size_t columns_ = 0;
+    size_t rows_ = 0;               // Ring size, including the row being filled
+    size_t current_row_ = 0;
+    size_t completed_rows_ = 0;
+
+    uint8_t* cell_row(size_t range_slot, size_t row) {
+        return cells_.data() + (range_slot * rows_ + row) * columns_;
+    }
+};
+
+} // namespace ui::external_app::ext_scanner
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef __EXT_SCANNER_RECORDING_H__
+#define __EXT_SCANNER_RECORDING_H__
+
+#include "scanner_detector.hpp"
+#include <array>
+#include <cstdint>
+
+// Sweep recording (.SWR) file layout, shared by the device and the host replay tool.
+// A file is one SweepRecordingHeader followed by any number of SweepRecordingFrame.
+// All fields are little-endian (native on both the LPC43xx and x86/ARM hosts).
+// Version 2 added overlap_bins in place of reserved; version 1 files read as overlap 0.
+// Version 3 flags revisit frames in the top bit of center_freq.
+
+namespace ui::external_app::ext_scanner {
+
+constexpr std::array<char, 4> SWEEP_RECORDING_MAGIC{'S', 'W', 'R', 'C'};
+constexpr uint16_t SWEEP_RECORDING_VERSION = 3;
+
+struct SweepRecordingHeader {
+    std::array<char, 4> magic{SWEEP_RECORDING_MAGIC};
+    uint16_t version{SWEEP_RECORDING_VERSION};
+    uint16_t bins_per_frame{SPECTRUM_BINS};
+    uint32_t slice_width{SPECTRUM_SLICE_WIDTH};
+    uint16_t overlap_bins{0};  // Sweep chunk overlap, see chunk_step()
+    uint16_t reserved{0};
+
+    bool is_valid() const {
+        return magic == SWEEP_RECORDING_MAGIC &&
+               version >= 1 && version <= SWEEP_RECORDING_VERSION &&
+               overlap_bins <= MAX_OVERLAP_BINS &&
+               bins_per_frame == SPECTRUM_BINS &&
+               slice_width == SPECTRUM_SLICE_WIDTH;
+    }
+};
+
+struct SweepRecordingFrame {
+    static constexpr uint64_t REVISIT_FLAG = 1ull << 63;
+
+    uint64_t center_freq;  // Tuned center frequency, Hz, | REVISIT_FLAG for revisits
+    std::array<uint8_t, SPECTRUM_BINS> db;
+
+    uint64_t frequency() const { return center_freq & ~REVISIT_FLAG; }
+    bool is_revisit() const { return center_freq & REVISIT_FLAG; }
+};
+
+static_assert(sizeof(SweepRecordingHeader) == 16, "Recording header layout changed");
+static_assert(sizeof(SweepRecordingFrame) == 8 + SPECTRUM_BINS, "Recording frame layout changed");
+
+} // namespace ui::external_app::ext_scanner
+
+#endif
@@ -0,0 +1,87 @@
+#include "scanner_stats.hpp"
+
+namespace ui::external_app::ext_scanner {
+
+namespace {
+
+constexpr const char* STAGE_NAMES[SWEEP_STAGE_COUNT] = {"Tune", "Settle", "Frames", "Analysis", "Format"};
+
+// Columns of the timing table, values clip at 6 digits
+constexpr size_t NAME_WIDTH = 9;
+constexpr size_t VALUE_WIDTH = 7;
+constexpr uint32_t VALUE_MAX = 999999;
+
+void append_name(TextLine& line, const char* name) {
+    const size_t start = line.size();
+    line.append(name);
+    while (line.size() < start + NAME_WIDTH) {
+        line.append(' ');
+    }
+}
+
+void append_value(TextLine& line, uint32_t value) {
+    line.append_uint(value < VALUE_MAX ? value : VALUE_MAX, VALUE_WIDTH);
+}
+
+}  // namespace
+
+void SweepStats::clear() {
+    stages_ = {};
+    cycle_history_ = {};
+    cycle_count_ = 0;
+    last_cycle_us_ = 0;
+    max_cycle_us_ = 0;
+    backlog_frames_ = 0;
+    overflow_detections_ = 0;
+}
+
+void SweepStats::add_cycle(uint32_t us) {
+    cycle_history_[cycle_count_ % CYCLE_HISTORY] = us;
+    cycle_count_++;
+    last_cycle_us_ = us;
+    if (us > max_cycle_us_) max_cycle_us_ = us;
+}
+
+uint32_t SweepStats::rolling_cycle_us() const {
+    const size_t count = cycle_count_ < CYCLE_HISTORY ? cycle_count_ : CYCLE_HISTORY;
+    if (count == 0) return 0;
+
+    uint64_t total = 0;
+    for (size_t i = 0; i < count; i++) {
+        total += cycle_history_[i];
+    }
+    return total / count;
+}
+
+void SweepStats::format_line(size_t index, const SweepPipeline& pipeline, TextLine& line) const {
+    line.clear();
+
+    if (index == 0) {
+        append_name(line, "us");
+        line.append("   last    avg    max");
+    } else if (index <= SWEEP_STAGE_COUNT) {
+        const auto& timing = stages_[index - 1];
+        append_name(line, STAGE_NAMES[index - 1]);
+        append_value(line, timing.last_us);
+        append_value(line, timing.mean_us());
+        append_value(line, timing.max_us);
+    } else if (index == SWEEP_STAGE_COUNT + 1) {
+        append_name(line, "Cycle ms");
+        append_value(line, last_cycle_us_ / 1000);
+        append_value(line, rolling_cycle_us() / 1000);
+        append_value(line, max_cycle_us_ / 1000);
+    } else if (index == SWEEP_STAGE_COUNT + 2) {
+        line.append("Cycles ").append_uint(cycle_count_);
+        line.append(" Chunks ").append_uint(stages_[(size_t)SweepStage::Analysis].count);
+    } else if (index == SWEEP_STAGE_COUNT + 3) {
+        line.append("Stale ").append_uint(pipeline.stale_count());
+        line.append(" Settle ").append_uint(pipeline.settle_count());
+    } else if (index == SWEEP_STAGE_COUNT + 4) {
+        line.append("Backlog ").append_uint(backlog_frames_);
+    } else if (index == SWEEP_STAGE_COUNT + 5) {
+        line.append("Detections over ").append_uint(SpectrumDetector::MAX_DETECTIONS_PER_FRAME);
+        line.append(": ").append_uint(overflow_detections_);
+    }
+}
+
+} // namespace ui::external_app::ext_scanner
@@ -0,0 +1,70 @@
+#ifndef __EXT_SCANNER_STATS_H__
+#define __EXT_SCANNER_STATS_H__
+
+#include "scanner_sweep.hpp"
+#include "scanner_text.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Where sweep time goes: per-stage timings of each chunk, cycle times, frame and detection counters.
+// Hardware-independent, the caller measures in microseconds.
+
+namespace ui::external_app::ext_scanner {
+
+enum class SweepStage : uint8_t {
+    Tune,      // Retune call, radio and stale frame flush
+    Settle,    // End of the retune to the first accepted frame
+    Frames,    // First accepted frame to the last dwell frame
+    Analysis,  // Detection, tracking and revisit scoring of a chunk
+    Format,    // Formatting the widget texts of one display refresh; painting and the LCD
+               // transfer run later in the event loop and aren't included
+};
+
+constexpr size_t SWEEP_STAGE_COUNT = 5;
+
+struct StageTiming {
+    uint32_t last_us = 0;
+    uint32_t max_us = 0;
+    uint32_t count = 0;
+    uint64_t total_us = 0;
+
+    void add(uint32_t us) {
+        last_us = us;
+        if (us > max_us) max_us = us;
+        count++;
+        total_us += us;
+    }
+    uint32_t mean_us() const { return count ? total_us / count : 0; }
+};
+
+class SweepStats {
+public:
+    static constexpr size_t CYCLE_HISTORY = 8;  // Rolling cycle time window
+
+    void clear();
+
+    void add(SweepStage stage, uint32_t us) { stages_[(size_t)stage].add(us); }
+    void add_cycle(uint32_t us);
+    void add_backlog(uint32_t frames) { backlog_frames_ += frames; }
+    void add_detection_overflow(uint32_t detections) { overflow_detections_ += detections; }
+
+    // Report line index (0..LINE_COUNT), 30 columns; frame counters come from the pipeline
+    static constexpr size_t LINE_COUNT = 11;
+    void format_line(size_t index, const SweepPipeline& pipeline, TextLine& line) const;
+
+private:
+    std::array<StageTiming, SWEEP_STAGE_COUNT> stages_{};
+    std::array<uint32_t, CYCLE_HISTORY> cycle_history_{};
+    uint32_t cycle_count_ = 0;
+    uint32_t last_cycle_us_ = 0;
+    uint32_t max_cycle_us_ = 0;
+    uint32_t backlog_frames_ = 0;       // Frames that queued up behind another within one display frame
+    uint32_t overflow_detections_ = 0;  // Detections past MAX_DETECTIONS_PER_FRAME, not frames
+
+    uint32_t rolling_cycle_us() const;  // Mean of the last CYCLE_HISTORY cycles
+};
+
+} // namespace ui::external_app::ext_scanner
+
+#endif
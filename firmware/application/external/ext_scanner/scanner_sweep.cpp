@@ -0,0 +1,254 @@
+#include "scanner_sweep.hpp"
+
+namespace ui::external_app::ext_scanner {
+
+size_t range_chunk_count(const FrequencyRange& range, uint32_t overlap_bins) {
+    const Frequency step = chunk_step(overlap_bins);
+    Frequency range_width = range.end - range.start;
+    return range_width > 0 ? (range_width + step - 1) / step : 1;
+}
+
+size_t sweep_chunk_count(const std::vector<FrequencyRange>& ranges, uint32_t overlap_bins) {
+    size_t count = 0;
+    for (auto& range : ranges) {
+        if (range.enabled) count += range_chunk_count(range, overlap_bins);
+    }
+    return count;
+}
+
+Frequency range_chunk_center(const FrequencyRange& range, uint32_t overlap_bins, size_t chunk_index) {
+    return range.start + (Frequency)chunk_index * chunk_step(overlap_bins) +
+           (SPECTRUM_SLICE_WIDTH / 2) - (Frequency)overlap_bins * BIN_WIDTH;
+}
+
+bool ChunkSequencer::find_enabled_range(size_t from) {
+    range_index_ = from;
+    while (range_index_ < ranges_.size() && !ranges_[range_index_].enabled) {
+        range_index_++;
+    }
+    return range_index_ < ranges_.size();
+}
+
+void ChunkSequencer::enter_range() {
+    auto& range = ranges_[range_index_];
+    chunk_count_ = range_chunk_count(range, overlap_bins_);
+    chunk_index_ = 0;
+    chunk_center_ = range_chunk_center(range, overlap_bins_, 0);
+}
+
+bool ChunkSequencer::start() {
+    overlap_bins_ = next_overlap_bins_;
+    chunk_id_ = 0;
+    if (!find_enabled_range(0)) {
+        chunk_count_ = 0;
+        return false;
+    }
+    enter_range();
+    return true;
+}
+
+bool ChunkSequencer::advance() {
+    // Ranges may be edited while scanning
+    if (range_index_ < ranges_.size() && ranges_[range_index_].enabled &&
+        chunk_index_ + 1 < chunk_count_) {
+        chunk_index_++;
+        chunk_id_++;
+        chunk_center_ += chunk_step(overlap_bins_);
+        return false;
+    }
+
+    // Finished current range, move to next
+    bool wrapped = false;
+    chunk_id_++;
+    if (!find_enabled_range(range_index_ + 1)) {
+        // Completed one full scan cycle
+        wrapped = true;
+        chunk_id_ = 0;
+        if (!find_enabled_range(0)) {
+            chunk_count_ = 0;
+            return true;
+        }
+    }
+    enter_range();
+    return wrapped;
+}
+
+ChunkSlot ChunkSequencer::slot() const {
+    ChunkSlot slot;
+    slot.range_index = range_index_;
+    slot.chunk_index = chunk_index_;
+    slot.chunk_count = chunk_count_;
+    slot.chunk_id = chunk_id_;
+    slot.center = chunk_center_;
+    return slot;
+}
+
+bool ChunkSequencer::locate(size_t chunk_id, ChunkSlot& slot) const {
+    size_t first_id = 0;
+    for (size_t i = 0; i < ranges_.size(); i++) {
+        auto& range = ranges_[i];
+        if (!range.enabled) continue;
+
+        size_t count = range_chunk_count(range, overlap_bins_);
+        if (chunk_id < first_id + count) {
+            slot.range_index = i;
+            slot.chunk_index = chunk_id - first_id;
+            slot.chunk_count = count;
+            slot.chunk_id = chunk_id;
+            slot.center = range_chunk_center(range, overlap_bins_, slot.chunk_index);
+            return true;
+        }
+        first_id += count;
+    }
+    return false;
+}
+
+bool ChunkSequencer::locate_frequency(Frequency freq, ChunkSlot& slot) const {
+    const Frequency step = chunk_step(overlap_bins_);
+    size_t first_id = 0;
+    for (size_t i = 0; i < ranges_.size(); i++) {
+        auto& range = ranges_[i];
+        if (!range.enabled) continue;
+
+        // The last chunk keeps bins past range.end
+        size_t count = range_chunk_count(range, overlap_bins_);
+        if (freq >= range.start && freq < range.start + (Frequency)count * step) {
+            return locate(first_id + (freq - range.start) / step, slot);
+        }
+        first_id += count;
+    }
+    return false;
+}
+
+void RevisitScheduler::clear_scores() {
+    score_.fill(0);
+    last_power_.fill(RAW_MIN);
+    focus_.fill(0);
+    revisit_cursor_ = 0;
+    linear_since_revisit_ = 0;
+}
+
+bool RevisitScheduler::start() {
+    clear_scores();
+    tracked_chunks_ = 0;
+    if (!sequencer_.start()) return false;
+    current_ = sequencer_.slot();
+    return true;
+}
+
+bool RevisitScheduler::advance() {
+    // Every REVISIT_INTERVAL linear chunks one slot goes to the next hot chunk
+    if (linear_since_revisit_ >= REVISIT_INTERVAL) {
+        linear_since_revisit_ = 0;
+        ChunkSlot slot;
+        if (pick_revisit(slot)) {
+            current_ = slot;
+            return false;
+        }
+    }
+
+    size_t last_chunk_id = sequencer_.chunk_id();
+    bool cycle_complete = sequencer_.advance();
+    if (cycle_complete) {
+        // Ranges were edited: chunk ids no longer match the scores
+        if (tracked_chunks_ && tracked_chunks_ != last_chunk_id + 1) {
+            clear_scores();
+        }
+        tracked_chunks_ = last_chunk_id + 1;
+    }
+
+    linear_since_revisit_++;
+    current_ = sequencer_.slot();
+    return cycle_complete;
+}
+
+bool RevisitScheduler::pick_revisit(ChunkSlot& slot) {
+    size_t limit = tracked_chunks_ ? tracked_chunks_ : sequencer_.chunk_id() + 1;
+    if (limit > MAX_TRACKED_CHUNKS) limit = MAX_TRACKED_CHUNKS;
+
+    for (size_t n = 0; n < limit; n++) {
+        size_t id = (revisit_cursor_ + n) % limit;
+        // The linear sweep is about to see the next chunk anyway
+        if (score_[id] >= HOT_SCORE && id != sequencer_.chunk_id() + 1) {
+            revisit_cursor_ = id + 1;
+            if (!sequencer_.locate(id, slot)) return false;
+            slot.shift_segments = focus_[id];
+            slot.center += focus_[id] * FLOOR_SEGMENT_WIDTH;
+            slot.revisit = true;
+            return true;
+        }
+    }
+    return false;
+}
+
+void RevisitScheduler::boost(size_t chunk_id, uint32_t amount) {
+    // Don't let non-dome activity push a decayed dome score back up to confirmation level
+    uint8_t& score = score_[chunk_id];
+    uint32_t boosted = score + amount;
+    if (score <= CANDIDATE_SCORE_CAP && boosted > CANDIDATE_SCORE_CAP) boosted = CANDIDATE_SCORE_CAP;
+    score = boosted < 255 ? boosted : 255;
+}
+
+bool RevisitScheduler::report(const ChunkSlot& slot, uint8_t max_power, const Detection* detections, size_t count) {
+    bool confirmed = false;
+    bool slot_active = false;
+    size_t last_boosted = MAX_TRACKED_CHUNKS;
+
+    // Domes are scored after the loop: a second dome in the same frame (an adjacent channel,
+    // a dome split by a dip) must not confirm the first, only a later visit may
+    struct DomeHit {
+        size_t chunk_id;
+        int8_t shift;
+    };
+    std::array<DomeHit, SpectrumDetector::MAX_DETECTIONS_PER_FRAME> dome_hits;
+    size_t dome_count = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        const Detection& detection = detections[i];
+        ChunkSlot holder;
+        if (!sequencer_.locate_frequency(detection.center, holder) || holder.chunk_id >= MAX_TRACKED_CHUNKS) {
+            continue;
+        }
+
+        const size_t id = holder.chunk_id;
+        if (id == slot.chunk_id) slot_active = true;
+
+        // Revisit tuned onto the run, rounded to whole segments
+        const Frequency offset = detection.center - holder.center;
+        int32_t shift = (offset + (offset < 0 ? -1 : 1) * FLOOR_SEGMENT_WIDTH / 2) / FLOOR_SEGMENT_WIDTH;
+        const int32_t max_shift = FLOOR_SEGMENTS / 2;
+        shift = shift < -max_shift ? -max_shift : (shift > max_shift ? max_shift : shift);
+
+        if (detection.has_video_dome) {
+            if (score_[id] > CANDIDATE_SCORE_CAP) confirmed = true;
+            if (dome_count < dome_hits.size()) dome_hits[dome_count++] = {id, (int8_t)shift};
+        } else {
+            // A dome keeps the revisit on itself
+            if (score_[id] <= CANDIDATE_SCORE_CAP) focus_[id] = shift;
+
+            // Detections come in frequency order: one candidate boost per chunk and frame
+            if (id != last_boosted) {
+                boost(id, CANDIDATE_SCORE);
+                last_boosted = id;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < dome_count; i++) {
+        score_[dome_hits[i].chunk_id] = 255;
+        focus_[dome_hits[i].chunk_id] = dome_hits[i].shift;
+    }
+
+    if (slot.chunk_id >= MAX_TRACKED_CHUNKS) return confirmed;
+
+    uint8_t& last_power = last_power_[slot.chunk_id];
+    if (max_power >= last_power + RISING_POWER_DELTA) {
+        boost(slot.chunk_id, RISING_SCORE);
+    } else if (!slot_active) {
+        score_[slot.chunk_id] -= score_[slot.chunk_id] >> 2;
+    }
+    last_power = max_power;
+    return confirmed;
+}
+
+} // namespace ui::external_app::ext_scanner
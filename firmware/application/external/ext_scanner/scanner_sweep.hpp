@@ -0,0 +1,198 @@
+#ifndef __EXT_SCANNER_SWEEP_H__
+#define __EXT_SCANNER_SWEEP_H__
+
+#include "scanner_detector.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Hardware-independent sweep scheduling: which chunk to tune next and which
+// frames of the continuously running spectrum stream are valid for a chunk.
+
+namespace ui::external_app::ext_scanner {
+
+struct FrequencyRange {
+    Frequency start;
+    Frequency end;
+    std::string name;
+    bool enabled;
+
+    FrequencyRange(Frequency s, Frequency e, std::string n = "", bool en = true)
+        : start(s), end(e), name(n), enabled(en) {}
+};
+
+// Chunks needed to cover a range when consecutive chunks overlap by 2 * overlap_bins
+size_t range_chunk_count(const FrequencyRange& range, uint32_t overlap_bins);
+
+// Chunks in one cycle of the linear sweep over the enabled ranges
+size_t sweep_chunk_count(const std::vector<FrequencyRange>& ranges, uint32_t overlap_bins);
+
+// Center of chunk chunk_index of a range; its kept bins start at range.start + chunk_index * chunk_step()
+Frequency range_chunk_center(const FrequencyRange& range, uint32_t overlap_bins, size_t chunk_index);
+
+// Revisits are tuned in whole noise floor segments off the chunk center
+constexpr Frequency FLOOR_SEGMENT_WIDTH = FLOOR_SEGMENT_BINS * BIN_WIDTH;  // 1.25 MHz
+
+// A chunk picked for capture
+struct ChunkSlot {
+    size_t range_index = 0;
+    size_t chunk_index = 0;  // Within the range
+    size_t chunk_count = 0;  // Chunks in the range
+    size_t chunk_id = 0;     // Position in the linear sweep over all enabled ranges
+    Frequency center = 0;    // Tuned center: the chunk center, shifted on a revisit
+    int32_t shift_segments = 0;  // center - chunk center, in FLOOR_SEGMENT_WIDTH
+    bool revisit = false;    // Out-of-order visit of an active chunk
+};
+
+// Walks every chunk of every enabled range in order, chunk_step(overlap_bins) apart
+class ChunkSequencer {
+public:
+    explicit ChunkSequencer(const std::vector<FrequencyRange>& ranges)
+        : ranges_(ranges) {}
+
+    // Takes effect on the next start()
+    void set_overlap_bins(uint32_t overlap_bins) {
+        next_overlap_bins_ = overlap_bins < MAX_OVERLAP_BINS ? overlap_bins : MAX_OVERLAP_BINS;
+    }
+    // Overlap the chunks of the current scan are laid out with
+    uint32_t overlap_bins() const { return overlap_bins_; }
+
+    // Position on the first chunk of the first enabled range. False if no range is enabled.
+    bool start();
+
+    // Move to the next chunk. True if this wrapped around, i.e. a full scan cycle completed.
+    bool advance();
+
+    size_t range_index() const { return range_index_; }
+    size_t chunk_index() const { return chunk_index_; }
+    size_t chunk_count() const { return chunk_count_; }
+    size_t chunk_id() const { return chunk_id_; }
+    Frequency chunk_center() const { return chunk_center_; }
+    ChunkSlot slot() const;
+
+    // Find the chunk at position chunk_id of the linear sweep. False if ranges no longer have it.
+    bool locate(size_t chunk_id, ChunkSlot& slot) const;
+
+    // Find the chunk whose kept bins hold freq. False if no enabled range covers it.
+    bool locate_frequency(Frequency freq, ChunkSlot& slot) const;
+
+private:
+    const std::vector<FrequencyRange>& ranges_;
+    uint32_t next_overlap_bins_ = DEFAULT_OVERLAP_BINS;
+    uint32_t overlap_bins_ = DEFAULT_OVERLAP_BINS;  // Fixed for a scan, chunk ids depend on it
+    size_t range_index_ = 0;
+    size_t chunk_index_ = 0;
+    size_t chunk_count_ = 0;
+    size_t chunk_id_ = 0;
+    Frequency chunk_center_ = 0;
+
+    bool find_enabled_range(size_t from);
+    void enter_range();
+};
+
+// Interleaves revisits of active chunks into the linear sweep.
+// Each chunk keeps a uint8 activity score: a dome sets it to the maximum, width-matching
+// candidates and rising power add to it, quiet visits decay it by a quarter. Chunks at
+// or above HOT_SCORE are revisited round-robin, one revisit per REVISIT_INTERVAL linear
+// chunks, so a quiet chunk is always seen again within (1 + 1/REVISIT_INTERVAL) cycles.
+// Detections score the chunk holding their run center, whichever frame measured them, and
+// the revisit is tuned onto that center, so a signal across a chunk edge is seen whole.
+class RevisitScheduler {
+public:
+    static constexpr size_t MAX_TRACKED_CHUNKS = 256;  // 4.8 GHz of span at the default overlap; later chunks are swept but never revisited
+    static constexpr size_t REVISIT_INTERVAL = 4;
+    static constexpr uint8_t HOT_SCORE = 64;
+    static constexpr uint8_t CANDIDATE_SCORE_CAP = 128;  // Only domes score above this
+    static constexpr uint8_t CANDIDATE_SCORE = 48;
+    static constexpr uint8_t RISING_SCORE = 24;
+    static constexpr uint8_t RISING_POWER_DELTA = 6;     // Raw units, ~3 dB
+
+    explicit RevisitScheduler(const std::vector<FrequencyRange>& ranges)
+        : sequencer_(ranges) {}
+
+    // Takes effect on the next start()
+    void set_overlap_bins(uint32_t overlap_bins) { sequencer_.set_overlap_bins(overlap_bins); }
+    uint32_t overlap_bins() const { return sequencer_.overlap_bins(); }
+
+    // Start a new scan with all scores cleared. False if no range is enabled.
+    bool start();
+
+    // Pick the next chunk to tune. True if the linear sweep completed a full cycle.
+    bool advance();
+
+    const ChunkSlot& current() const { return current_; }
+
+    // Score the chunks holding the detections of a frame, then the power trend of the
+    // frame's own chunk. True if a dome was seen on a chunk that already had a dome on a
+    // recent visit.
+    bool report(const ChunkSlot& slot, uint8_t max_power, const Detection* detections, size_t count);
+
+private:
+    ChunkSequencer sequencer_;
+    ChunkSlot current_{};
+    std::array<uint8_t, MAX_TRACKED_CHUNKS> score_{};
+    std::array<uint8_t, MAX_TRACKED_CHUNKS> last_power_{};
+    std::array<int8_t, MAX_TRACKED_CHUNKS> focus_{};  // Revisit shift_segments, onto the last detection
+    size_t tracked_chunks_ = 0;  // Chunks per cycle, known after the first wrap
+    size_t revisit_cursor_ = 0;
+    size_t linear_since_revisit_ = 0;
+
+    bool pick_revisit(ChunkSlot& slot);
+    void clear_scores();
+    void boost(size_t chunk_id, uint32_t amount);
+};
+
+// Decides which frames of a running stream belong to the chunk the radio is tuned to.
+// Streaming is never stopped for a retune: frames already queued when the radio moved
+// are flushed by the caller, and the next settle_frames frames are discarded while the
+// PLL settles and the FFT window refills.
+// Frames are discarded by count, not by a tuning tag: ChannelSpectrum carries no tag and
+// adding one needs a baseband change. The first frame after a retune is the one whose FFT
+// window can straddle it, so at least MIN_SETTLE_FRAMES are always discarded.
+class SweepPipeline {
+public:
+    static constexpr uint32_t MIN_SETTLE_FRAMES = 1;
+    static constexpr uint32_t DEFAULT_SETTLE_FRAMES = 1;
+    static constexpr uint32_t MAX_SETTLE_FRAMES = 4;
+
+    void set_settle_frames(uint32_t frames) {
+        settle_frames_ = frames < MIN_SETTLE_FRAMES ? MIN_SETTLE_FRAMES
+                                                    : (frames < MAX_SETTLE_FRAMES ? frames : MAX_SETTLE_FRAMES);
+    }
+    uint32_t settle_frames() const { return settle_frames_; }
+
+    // Radio was moved to a new chunk
+    void retuned() { frames_to_discard_ = settle_frames_; }
+
+    // Frame that was queued before the last retune
+    void stale_frame() { stale_count_++; }
+
+    // True if the frame is valid for the current chunk, false if it must be discarded
+    bool accept_frame() {
+        if (frames_to_discard_ > 0) {
+            frames_to_discard_--;
+            settle_count_++;
+            return false;
+        }
+        return true;
+    }
+
+    void reset_counters() {
+        stale_count_ = 0;
+        settle_count_ = 0;
+    }
+    uint32_t stale_count() const { return stale_count_; }
+    uint32_t settle_count() const { return settle_count_; }
+
+private:
+    uint32_t settle_frames_ = DEFAULT_SETTLE_FRAMES;
+    uint32_t frames_to_discard_ = 0;
+    uint32_t stale_count_ = 0;
+    uint32_t settle_count_ = 0;
+};
+
+} // namespace ui::external_app::ext_scanner
+
+#endif
@@ -0,0 +1,75 @@
+#include "scanner_text.hpp"
+#include <cstring>
+
+namespace ui::external_app::ext_scanner {
+
+TextLine& TextLine::clear() {
+    size_ = 0;
+    buffer_[0] = 0;
+    return *this;
+}
+
+TextLine& TextLine::append(const char* text) {
+    while (*text && size_ < CAPACITY) {
+        buffer_[size_++] = *text++;
+    }
+    buffer_[size_] = 0;
+    return *this;
+}
+
+TextLine& TextLine::append(char c) {
+    const char text[2] = {c, 0};
+    return append(text);
+}
+
+TextLine& TextLine::append_uint(uint32_t value, size_t width) {
+    // Digits backwards into a scratch buffer, 10 is enough for any uint32
+    char digits[11];
+    size_t count = 0;
+    do {
+        digits[count++] = '0' + value % 10;
+        value /= 10;
+    } while (value > 0);
+
+    for (; width > count; width--) {
+        append(' ');
+    }
+    while (count > 0) {
+        append(digits[--count]);
+    }
+    return *this;
+}
+
+TextLine& TextLine::append_int(int32_t value, size_t width) {
+    const uint32_t magnitude = value < 0 ? 0u - (uint32_t)value : (uint32_t)value;
+    if (value >= 0) return append_uint(magnitude, width);
+
+    // Sign next to the digits, padding before it
+    size_t digits = 1;
+    for (uint32_t rest = magnitude / 10; rest > 0; rest /= 10) {
+        digits++;
+    }
+    for (; width > digits + 1; width--) {
+        append(' ');
+    }
+    append('-');
+    return append_uint(magnitude);
+}
+
+TextLine& TextLine::append_mhz(Frequency freq) {
+    if (freq < 0) freq = 0;
+
+    // Round to 10 kHz first, so 5804.999 MHz shows as 5805.00
+    const uint64_t tens_of_khz = ((uint64_t)freq + 5000) / 10000;
+    append_uint(tens_of_khz / 100);
+    append('.');
+    const uint32_t fraction = tens_of_khz % 100;
+    if (fraction < 10) append('0');
+    return append_uint(fraction);
+}
+
+bool TextLine::operator==(const TextLine& other) const {
+    return size_ == other.size_ && std::memcmp(buffer_.data(), other.buffer_.data(), size_) == 0;
+}
+
+} // namespace ui::external_app::ext_scanner
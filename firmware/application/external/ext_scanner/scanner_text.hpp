@@ -0,0 +1,40 @@
+#ifndef __EXT_SCANNER_TEXT_H__
+#define __EXT_SCANNER_TEXT_H__
+
+#include "scanner_detector.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace ui::external_app::ext_scanner {
+
+// Fixed-size line for widgets and text files, formatted without touching the heap.
+// Appends past CAPACITY are cut off.
+class TextLine {
+public:
+    static constexpr size_t CAPACITY = 40;  // Screen lines are 30 characters
+
+    TextLine() = default;
+    explicit TextLine(const char* text) { append(text); }
+
+    TextLine& clear();
+    TextLine& append(const char* text);
+    TextLine& append(char c);
+    TextLine& append_uint(uint32_t value, size_t width = 0);  // Right-aligned in width, space filled
+    TextLine& append_int(int32_t value, size_t width = 0);
+    TextLine& append_mhz(Frequency freq);                     // "5805.08", 10 kHz resolution
+
+    const char* c_str() const { return buffer_.data(); }
+    size_t size() const { return size_; }
+
+    bool operator==(const TextLine& other) const;
+    bool operator!=(const TextLine& other) const { return !(*this == other); }
+
+private:
+    std::array<char, CAPACITY + 1> buffer_{};
+    size_t size_ = 0;
+};
+
+} // namespace ui::external_app::ext_scanner
+
+#endif
@@ -10,21 +10,21 @@
 #include "ui_menu.hpp"
 #include "message.hpp"
 #include "receiver_model.hpp"
+#include "ch.h"
+#include "file.hpp"
+#include "scanner_detector.hpp"
+#include "scanner_dwell.hpp"
+#include "scanner_emitters.hpp"
+#include "scanner_noise_floor.hpp"
+#include "scanner_overview.hpp"
+#include "scanner_stats.hpp"
+#include "scanner_sweep.hpp"
+#include <memory>
 #include <vector>
 #include <string>
 
 namespace ui::external_app::ext_scanner {
 
-struct FrequencyRange {
-    rf::Frequency start;
-    rf::Frequency end;
-    std::string name;
-    bool enabled;
-    
-    FrequencyRange(rf::Frequency s, rf::Frequency e, std::string n = "", bool en = true)
-        : start(s), end(e), name(n), enabled(en) {}
-};
-
 class RangeEditorView : public View {
 public:
     RangeEditorView(NavigationView& nav, std::vector<FrequencyRange>& ranges, size_t index, bool is_new);
@@ -87,6 +87,48 @@ private:
     void edit_range(size_t index);
 };
 
+// Sweep timings and frame counters of the running scan. A snapshot: Refresh re-reads it,
+// Save writes it to /SCANNER/STATS_nnnn.TXT.
+class ScannerStatsView : public View {
+public:
+    ScannerStatsView(NavigationView& nav, const SweepStats& stats, const SweepPipeline& pipeline);
+    
+    ScannerStatsView(const ScannerStatsView&) = delete;
+    ScannerStatsView& operator=(const ScannerStatsView&) = delete;
+    
+    void focus() override;
+    void on_show() override;
+    std::string title() const override { return "Scanner Stats"; }
+
+private:
+    NavigationView& nav_;
+    const SweepStats& stats_;
+    const SweepPipeline& pipeline_;
+    
+    Console console {{ 0, 1*16, 240, 12*16 }};
+    Text text_saved {{ 1*8, 13*16, 28*8, 16 }, ""};
+    Button button_refresh {{ 1*8, 15*16, 8*8, 2*16 }, "Refresh"};
+    Button button_save {{ 11*8, 15*16, 8*8, 2*16 }, "Save"};
+    Button button_back {{ 21*8, 15*16, 8*8, 2*16 }, "Back"};
+    
+    void refresh();
+    void save();
+};
+
+// All enabled ranges side by side, one SpectrumOverview row per scan cycle, newest on top
+class OverviewStrip : public Widget {
+public:
+    static constexpr int ROW_HEIGHT = 2;
+
+    OverviewStrip(Rect parent_rect, const SpectrumOverview& overview)
+        : Widget{parent_rect}, overview_(overview) {}
+
+    void paint(Painter& painter) override;
+
+private:
+    const SpectrumOverview& overview_;
+};
+
 class ScannerAppView : public View {
 public:
     ScannerAppView(NavigationView& nav);
@@ -102,17 +144,17 @@ public:
 private:
     NavigationView& nav_;
     std::vector<FrequencyRange> scan_ranges;
-    size_t current_range_index = 0;
     rf::Frequency current_freq = 0;
     int32_t squelch_threshold = -100;  // More reasonable default for RF
     uint32_t min_signal_width_mhz = 4;  // 4 MHz default
     uint32_t max_signal_width_mhz = 8;  // 8 MHz default
+    int32_t floor_margin_db = 0;        // Threshold above learned noise floor, 0 = fixed threshold
     bool is_scanning = false;
     bool is_paused = false;
-    
-    // Spectrum capture settings
-    static constexpr uint32_t SPECTRUM_SLICE_WIDTH = 20000000;  // 20 MHz chunks
-    static constexpr size_t SPECTRUM_BINS = 256;  // FFT bins per chunk
+    uint32_t settle_frames = SweepPipeline::DEFAULT_SETTLE_FRAMES;
+    uint32_t dwell_frames = 1;
+    DwellMode dwell_mode = DwellMode::MaxHold;
+    uint32_t overlap_bins = DEFAULT_OVERLAP_BINS;  // Applied on START, chunk ids depend on it
     
     // Cycle scanning variables
     bool in_scan_cycle = true;
@@ -122,22 +164,45 @@ private:
     rf::Frequency start_freq = 0;
     
     // Current chunk scanning
-    rf::Frequency current_chunk_center = 0;
-    size_t current_chunk_in_range = 0;
-    size_t total_chunks_in_range = 0;
+    RevisitScheduler scheduler{scan_ranges};
+    SweepPipeline pipeline{};
+    DwellAccumulator dwell{};
+    uint32_t cycle_start_us = 0;
+    uint32_t cycle_frames_per_chunk = 1;       // Settle + dwell frames this cycle was started with
+    uint32_t last_cycle_ms = 0;
+    uint32_t last_cycle_frames_per_chunk = 1;
     
     // Signal tracking from spectrum data
     rf::Frequency widest_signal_width = 0;
     rf::Frequency widest_signal_freq = 0;
     int32_t widest_signal_rssi = -999;
-    uint32_t dome_signals_count = 0;       // Signals with FM dome shape (FPV drones)
-    bool threat_detected = false;          // True when FPV drone found - triggers stop at cycle end
+    uint32_t dome_signals_count = 0;       // Distinct emitters with FM dome shape (FPV drones)
+    bool threat_detected = false;          // True when FPV drone found - triggers stop at cycle end (or on revisit)
+    
+    // Detection logic (threshold, run extraction on the stitched spectrum, dome test)
+    SpectrumDetector detector{};
+    NoiseFloorModel noise_floor{};
+    EmitterTracker emitters{};  // Dedups detections across frames, revisits and cycles
+    SpectrumOverview overview{};
+    static constexpr size_t OVERVIEW_COLUMNS = 120;  // Per range, memory bounded by SpectrumOverview::MAX_BYTES
+    static constexpr size_t OVERVIEW_ROWS = 16;      // Fills the strip at OverviewStrip::ROW_HEIGHT
+    
+    // Per-stage timings (see scanner_stats.hpp) and the chunk timeline they are taken from
+    SweepStats stats{};
+    uint32_t tune_end_us = 0;
+    uint32_t chunk_first_frame_us = 0;
+    bool chunk_has_frame = false;
     
-    // Cross-chunk signal tracking (for signals spanning multiple 20 MHz chunks)
-    bool signal_at_chunk_end = false;      // Signal continues to end of previous chunk
-    size_t chunk_end_signal_start_bin = 0; // Where it started in previous chunk
-    uint8_t chunk_end_peak_power = 0;      // Peak power in previous chunk portion
-    rf::Frequency pending_signal_freq = 0; // Center freq of pending cross-chunk signal
+    // Widgets are refreshed from this state once per display frame (refresh_display),
+    // each only when its formatted line changed
+    uint8_t chunk_max_power = RAW_MIN;
+    bool chunk_power_valid = false;
+    TextLine status_line{"Status: Idle"};
+    TextLine shown_range{}, shown_chunk{}, shown_rssi{}, shown_widest{};
+    TextLine shown_threats{}, shown_status{}, shown_cycle_time{};
+    
+    // Raw sweep recording to SD card for host replay (see scanner_recording.hpp)
+    std::unique_ptr<File> record_file{};
     
     // Spectrum data FIFO
     ChannelSpectrumFIFO* fifo{nullptr};
@@ -145,20 +210,39 @@ private:
     Labels labels {
         {{ 0*8, 1*16 }, "Ranges:", Color::light_grey()},
         {{ 0*8, 4*16 }, "Threshold:", Color::light_grey()},
+        {{ 21*8, 4*16 }, "Settle:", Color::light_grey()},
+        {{ 0*8, 5*16 }, "Floor+:", Color::light_grey()},
+        {{ 20*8, 5*16 }, "Overlap:", Color::light_grey()},
         {{ 0*8, 6*16 }, "BW Min:", Color::light_grey()},
         {{ 0*8, 7*16 }, "BW Max:", Color::light_grey()},
-        {{ 0*8, 8*16 }, "Mode:", Color::light_grey()}
+        {{ 0*8, 8*16 }, "Dwell:", Color::light_grey()}
     };
     
     Text text_range_count {{ 9*8, 1*16, 20*8, 16 }, "0 ranges"};
     Button button_manage_ranges {{ 1*8, 2*16, 15*8, 2*16 }, "Manage Ranges"};
+    Button button_stats {{ 18*8, 2*16, 10*8, 2*16 }, "Stats"};
     NumberField field_threshold {{ 12*8, 4*16 }, 4, {-120, -20}, 1, ' '};
     Text text_threshold_unit {{ 17*8, 4*16, 3*8, 16 }, "dBm"};
-    NumberField field_bw_min {{ 9*8, 6*16 }, 3, {1, 100}, 1, ' '};
+    NumberField field_settle {{ 28*8, 4*16 }, 1, {(int32_t)SweepPipeline::MIN_SETTLE_FRAMES, (int32_t)SweepPipeline::MAX_SETTLE_FRAMES}, 1, ' '};
+    NumberField field_floor_margin {{ 12*8, 5*16 }, 4, {0, 40}, 1, ' '};
+    Text text_floor_unit {{ 17*8, 5*16, 2*8, 16 }, "dB"};  // 0 = off
+    NumberField field_bw_min {{ 9*8, 6*16 }, 3, {1, (int32_t)SpectrumDetector::MAX_SIGNAL_WIDTH_MHZ}, 1, ' '};
     Text text_bw_min_unit {{ 12*8, 6*16, 3*8, 16 }, "MHz"};
-    NumberField field_bw_max {{ 9*8, 7*16 }, 3, {1, 100}, 1, ' '};
+    NumberField field_bw_max {{ 9*8, 7*16 }, 3, {1, (int32_t)SpectrumDetector::MAX_SIGNAL_WIDTH_MHZ}, 1, ' '};
     Text text_bw_max_unit {{ 12*8, 7*16, 3*8, 16 }, "MHz"};
-    Text text_mode {{ 6*8, 8*16, 23*8, 16 }, "Spectrum (20MHz)"};
+    NumberField field_overlap {{ 28*8, 5*16 }, 2, {0, (int32_t)MAX_OVERLAP_BINS}, 1, ' '};
+    Checkbox checkbox_record {{ 18*8, 6*16 }, 3, "REC"};
+    NumberField field_dwell {{ 7*8, 8*16 }, 1, {1, (int32_t)DwellAccumulator::MAX_FRAMES}, 1, ' '};
+    OptionsField options_dwell_mode {
+        { 9*8, 8*16 },
+        4,
+        {
+            {"Max", (int32_t)DwellMode::MaxHold},
+            {"Mean", (int32_t)DwellMode::Mean},
+            {"Min", (int32_t)DwellMode::Min}
+        }
+    };
+    Text text_cycle_time {{ 14*8, 8*16, 16*8, 16 }, "--- ms/cycle"};
 
     Button button_scan_start {{ 1*8, 10*16, 8*8, 16 }, "START"};
     Button button_pause_resume {{ 10*8, 10*16, 8*8, 16 }, "PAUSE"};
@@ -169,6 +253,7 @@ private:
     Text text_widest {{ 0*8, 14*16, 30*8, 16 }, "Widest: ---"};
     Text text_dome_signals {{ 0*8, 15*16, 30*8, 16 }, "FPV Threats: 0"};
     Text text_status {{ 0*8, 16*16, 30*8, 16 }, "Status: Idle"};
+    OverviewStrip overview_strip {{ 0*8, 17*16, 30*8, 2*16 }, overview};
     
     MessageHandlerRegistration message_handler_spectrum_config {
         Message::ID::ChannelSpectrumConfig,
@@ -181,29 +266,31 @@ private:
     MessageHandlerRegistration message_handler_frame_sync {
         Message::ID::DisplayFrameSync,
         [this](const Message* const) {
-            if (this->fifo) {
-                ChannelSpectrum channel_spectrum;
-                while (fifo->out(channel_spectrum)) {
-                    this->on_channel_spectrum(channel_spectrum);
-                }
-            }
+            this->on_frame_sync();
         }
     };
+    void on_frame_sync();
     void on_channel_spectrum(const ChannelSpectrum& spectrum);
-    bool analyze_fm_dome_shape(const ChannelSpectrum& spectrum, size_t start_bin, size_t end_bin);
     void start_scanning();
     void pause_scanning();
     void resume_scanning();
     void stop_scanning();
-    void scan_next_chunk();
-    void move_to_next_range();
+    bool scan_next_chunk();
+    void on_cycle_complete();
+    void on_threat_confirmed();
     void tune_to_chunk_center(rf::Frequency center_freq);
-    void process_spectrum_bins(const ChannelSpectrum& spectrum);
-    void on_signal_found(rf::Frequency freq, int32_t rssi, rf::Frequency width);
-    void update_display();
+    void flush_stale_frames();
+    const SpectrumDetector::FrameResult& process_spectrum_bins(const uint8_t* db, const ChunkSlot& slot);
+    void on_signal_found(const Detection& detection);
+    void set_status(const char* status);
+    void set_status(const TextLine& status);
+    void refresh_display();
     void update_range_count();
-    void calculate_chunk_count();
     void load_default_ranges();
+    void update_detector_config();
+    void start_recording();
+    void stop_recording();
+    void record_frame(const ChannelSpectrum& spectrum, const ChunkSlot& slot);
     void play_alert_tone();
     void stop_alert_tone();
 };
@@ -1,6 +1,16 @@
 set(EXTCPPSRC
 	#ext_scanner
 	external/ext_scanner/external_app_scanner.cpp
+	external/ext_scanner/scanner_bin_kernel.cpp
+	external/ext_scanner/scanner_detector.cpp
+	external/ext_scanner/scanner_dome.cpp
+	external/ext_scanner/scanner_dwell.cpp
+	external/ext_scanner/scanner_emitters.cpp
+	external/ext_scanner/scanner_noise_floor.cpp
+	external/ext_scanner/scanner_overview.cpp
+	external/ext_scanner/scanner_stats.cpp
+	external/ext_scanner/scanner_sweep.cpp
+	external/ext_scanner/scanner_text.cpp
 )
 
 set(EXTAPPLIST